@@ -0,0 +1,101 @@
+// Cost of short-lived inter-thread channels, each created, used for one message and destroyed,
+// as a thread pool handing work over a channel per request would.
+// Usage: bench_channel_creation [channel_count] [thread_count]
+// Named channels go through the process wide registry with CreateProducer and CreateConsumer,
+// pairs are created with CreatePair and never touch it. Every thread creates channel_count
+// channels, with names of its own.
+#include "bench_utils.hpp"
+#include "channel_interface.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <fmt/core.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+static auto UseChannel(pika::Producer<uint64_t>& producer, pika::Consumer<uint64_t>& consumer,
+    uint64_t packet) -> bool
+{
+    uint64_t recv_packet {};
+    return producer.Send(packet).has_value() && consumer.Receive(recv_packet).has_value()
+        && recv_packet == packet;
+}
+
+static auto RunNamedChannels(uint64_t thread_index, uint64_t channel_count) -> bool
+{
+    for (uint64_t i = 0; i < channel_count; ++i) {
+        auto const params = pika::ChannelParameters {
+            .channel_name = fmt::format("/bench_channel_creation_{}_{}", thread_index, i),
+            .queue_size = 64,
+            .channel_type = pika::ChannelType::InterThread,
+            .single_producer_single_consumer_mode = true
+        };
+        auto producer = pika::Channel::CreateProducer<uint64_t>(params);
+        auto consumer = pika::Channel::CreateConsumer<uint64_t>(params);
+        if (not producer.has_value() || not consumer.has_value()
+            || not UseChannel(*producer, *consumer, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static auto RunChannelPairs(uint64_t, uint64_t channel_count) -> bool
+{
+    auto const params = pika::ChannelParameters { .channel_name = "",
+        .queue_size = 64,
+        .channel_type = pika::ChannelType::InterThread,
+        .single_producer_single_consumer_mode = true };
+    for (uint64_t i = 0; i < channel_count; ++i) {
+        auto pair = pika::Channel::CreatePair<uint64_t>(params);
+        if (not pair.has_value() || not UseChannel(pair->producer, pair->consumer, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static auto RunThreads(bool (*run)(uint64_t, uint64_t), std::string const& name,
+    uint64_t channel_count, uint64_t thread_count) -> bool
+{
+    std::vector<std::thread> threads;
+    std::vector<uint8_t> success(thread_count, 0);
+    BenchTimer timer;
+    for (uint64_t thread_index = 0; thread_index < thread_count; ++thread_index) {
+        threads.emplace_back([&, thread_index]() {
+            success[thread_index] = run(thread_index, channel_count) ? 1 : 0;
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    auto const elapsed_ns = timer.ElapsedDurationNs();
+    for (auto const thread_success : success) {
+        if (thread_success == 0) {
+            fmt::println(stderr, "{} failed", name);
+            return false;
+        }
+    }
+    auto const total_channel_count = channel_count * thread_count;
+    fmt::println("{:<48} {:>12.0f} channels/s {:>10.2f} ns/channel", name,
+        static_cast<double>(total_channel_count) / (static_cast<double>(elapsed_ns) / 1e9),
+        static_cast<double>(elapsed_ns) / static_cast<double>(total_channel_count));
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    auto const channel_count = static_cast<uint64_t>(GetArgument(argc, argv, 1, 100'000));
+    auto const max_thread_count = static_cast<uint64_t>(
+        GetArgument(argc, argv, 2, std::max(1U, std::thread::hardware_concurrency())));
+    for (uint64_t thread_count = 1; thread_count <= max_thread_count; thread_count *= 2) {
+        if (not RunThreads(RunNamedChannels, fmt::format("Named channels x{}", thread_count),
+                channel_count, thread_count)
+            || not RunThreads(RunChannelPairs, fmt::format("Channel pairs x{}", thread_count),
+                channel_count, thread_count)) {
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Time to set up many channels, as a service creating all of its channels at startup would.
+// Usage: bench_channel_startup [channel_count]
+// Creates channel_count channels of every channel type, a producer and a consumer each, all kept
+// alive until the last one is created, then tears them down. Reports the setup time per channel,
+// which includes creating and mapping the memory segment and initializing the channel header.
+#include "bench_utils.hpp"
+#include "channel_interface.hpp"
+
+#include <cstdint>
+#include <fmt/core.h>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+struct Endpoints {
+    std::unique_ptr<pika::Producer<uint64_t>> producer;
+    std::unique_ptr<pika::Consumer<uint64_t>> consumer;
+    int32_t channel_fd = -1;
+};
+
+static auto CreateChannel(pika::ChannelType channel_type, uint64_t index)
+    -> std::optional<Endpoints>
+{
+    auto endpoints = Endpoints {};
+    if (channel_type == pika::ChannelType::AnonymousInterProcess) {
+        auto channel_fd = pika::Channel::CreateAnonymousChannel();
+        if (not channel_fd.has_value()) {
+            fmt::println(stderr, "{}", channel_fd.error().error_message);
+            return std::nullopt;
+        }
+        endpoints.channel_fd = *channel_fd;
+    }
+    auto const params = pika::ChannelParameters {
+        .channel_name = fmt::format("/bench_channel_startup_{}", index),
+        .queue_size = 64,
+        .channel_type = channel_type,
+        .single_producer_single_consumer_mode = true,
+        .channel_fd = endpoints.channel_fd,
+    };
+    auto producer = pika::Channel::CreateProducerOnHeap<uint64_t>(params);
+    auto consumer = pika::Channel::CreateConsumerOnHeap<uint64_t>(params);
+    if (endpoints.channel_fd != -1) {
+        close(endpoints.channel_fd);
+    }
+    if (not producer.has_value() || not consumer.has_value()) {
+        fmt::println(stderr, "{}",
+            producer.has_value() ? consumer.error().error_message : producer.error().error_message);
+        return std::nullopt;
+    }
+    endpoints.producer = std::move(*producer);
+    endpoints.consumer = std::move(*consumer);
+    return endpoints;
+}
+
+static auto RunStartup(pika::ChannelType channel_type, char const* name, uint64_t channel_count)
+    -> bool
+{
+    std::vector<Endpoints> channels;
+    channels.reserve(channel_count);
+    BenchTimer timer;
+    for (uint64_t i = 0; i < channel_count; ++i) {
+        auto endpoints = CreateChannel(channel_type, i);
+        if (not endpoints.has_value()) {
+            return false;
+        }
+        channels.push_back(std::move(*endpoints));
+    }
+    auto const elapsed_ns = timer.ElapsedDurationNs();
+    fmt::println("{:<48} {:>12.0f} channels/s {:>10.2f} us/channel", name,
+        static_cast<double>(channel_count) / (static_cast<double>(elapsed_ns) / 1e9),
+        static_cast<double>(elapsed_ns) / 1e3 / static_cast<double>(channel_count));
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    auto const channel_count = static_cast<uint64_t>(GetArgument(argc, argv, 1, 1000));
+    struct ChannelTypeEntry {
+        pika::ChannelType channel_type;
+        char const* name;
+    };
+    auto const channel_types = std::vector<ChannelTypeEntry> {
+        { pika::ChannelType::InterThread, "Inter-thread" },
+        { pika::ChannelType::InterProcess, "Inter-process" },
+        { pika::ChannelType::AnonymousInterProcess, "Anonymous inter-process" },
+    };
+    for (auto const& entry : channel_types) {
+        if (not RunStartup(entry.channel_type, entry.name, channel_count)) {
+            return 1;
+        }
+    }
+    return 0;
+}
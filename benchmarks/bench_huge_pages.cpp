@@ -0,0 +1,102 @@
+// Throughput and data TLB misses of a large inter-process channel backed by regular pages,
+// transparent huge pages and explicit (hugetlbfs) huge pages.
+// Usage: bench_huge_pages [queue_megabytes] [sweep_count]
+// Every sweep fills the whole ring and then drains it, so that each pass touches every page of
+// the segment. Modes whose huge pages are not available fall back to regular pages and print
+// why, see HugePageMode in channel_interface.hpp for the required system configuration.
+#include "bench_utils.hpp"
+#include "channel_interface.hpp"
+
+#include <cstdint>
+#include <fmt/core.h>
+#include <vector>
+
+struct Message {
+    uint64_t sequence_number;
+    uint8_t payload[56];
+};
+
+static auto RunSweeps(pika::HugePageMode huge_page_mode, char const* name, uint64_t queue_size,
+    uint64_t sweep_count) -> bool
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/bench_huge_pages",
+        .queue_size = queue_size,
+        .channel_type = pika::ChannelType::InterProcess,
+        .single_producer_single_consumer_mode = true,
+        .huge_page_mode = huge_page_mode };
+    auto producer = pika::Channel::CreateProducer<Message>(params);
+    if (not producer.has_value()) {
+        fmt::println(stderr, "{}", producer.error().error_message);
+        return false;
+    }
+    auto consumer = pika::Channel::CreateConsumer<Message>(params);
+    if (not consumer.has_value()) {
+        fmt::println(stderr, "{}", consumer.error().error_message);
+        return false;
+    }
+    auto const backing = producer->GetSegmentBacking();
+    if (not backing.fallback_reason.empty()) {
+        fmt::println("{}: falling back to regular pages, {}", name, backing.fallback_reason);
+    }
+
+    auto const sweep = [&]() -> bool {
+        auto message = Message {};
+        for (uint64_t i = 0; i < queue_size; ++i) {
+            message.sequence_number = i;
+            if (not producer->Send(message).has_value()) {
+                return false;
+            }
+        }
+        for (uint64_t i = 0; i < queue_size; ++i) {
+            if (not consumer->Receive(message).has_value() || message.sequence_number != i) {
+                return false;
+            }
+        }
+        return true;
+    };
+    // Fault every page in before measuring
+    if (not sweep()) {
+        return false;
+    }
+    auto tlb_misses = PerfCounter::DataTlbReadMisses();
+    BenchTimer timer;
+    tlb_misses.Start();
+    for (uint64_t i = 0; i < sweep_count; ++i) {
+        if (not sweep()) {
+            return false;
+        }
+    }
+    auto const miss_count = tlb_misses.Stop();
+    auto const elapsed_ns = timer.ElapsedDurationNs();
+
+    auto const message_count = 2 * queue_size * sweep_count;
+    ReportThroughput(fmt::format("{} ({} KiB pages)", name, backing.page_size / 1024),
+        message_count, elapsed_ns);
+    if (tlb_misses.IsAvailable()) {
+        fmt::println("{:<48} {:>12.4f} dTLB read misses/msg", "",
+            static_cast<double>(miss_count) / static_cast<double>(message_count));
+    } else {
+        fmt::println("{:<48} {:>12} dTLB read misses/msg", "", "n/a");
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    auto const queue_bytes = static_cast<uint64_t>(GetArgument(argc, argv, 1, 256)) << 20;
+    auto const sweep_count = static_cast<uint64_t>(GetArgument(argc, argv, 2, 8));
+    auto const queue_size = queue_bytes / sizeof(Message);
+    struct Mode {
+        pika::HugePageMode huge_page_mode;
+        char const* name;
+    };
+    auto const modes = std::vector<Mode> { { pika::HugePageMode::None, "Regular pages" },
+        { pika::HugePageMode::Transparent, "Transparent huge pages" },
+        { pika::HugePageMode::Explicit, "Explicit huge pages" } };
+    for (auto const& mode : modes) {
+        if (not RunSweeps(mode.huge_page_mode, mode.name, queue_size, sweep_count)) {
+            return 1;
+        }
+    }
+    return 0;
+}
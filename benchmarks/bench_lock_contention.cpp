@@ -0,0 +1,153 @@
+// Throughput of the lock based queue modes under producer/consumer contention: the coarse
+// grained LockProtected ring, with a pthread or a futex mutex, against the TwoLock ring with
+// separate producer and consumer locks.
+// Usage: bench_lock_contention [message_count]
+// Every configuration transfers message_count messages, split evenly over the producers and
+// over the consumers. LockProtected configurations also report how many condition variable
+// signals were issued and how many were skipped because nobody was waiting.
+#include "bench_utils.hpp"
+#include "channel_interface.hpp"
+#include "process_fork.hpp"
+
+#include <cstdint>
+#include <fmt/core.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+static auto RunConsumers(pika::ChannelParameters const& params, uint64_t consumer_count,
+    uint64_t message_count, std::string const& name) -> bool
+{
+    auto const messages_per_consumer = message_count / consumer_count;
+    std::vector<std::thread> consumer_threads;
+    std::vector<uint8_t> success(consumer_count, 0);
+    BenchTimer timer;
+    for (uint64_t consumer_index = 0; consumer_index < consumer_count; ++consumer_index) {
+        consumer_threads.emplace_back([&, consumer_index]() {
+            auto consumer = pika::Channel::CreateConsumer<uint64_t>(params);
+            if (not consumer.has_value()) {
+                fmt::println(stderr, "{}", consumer.error().error_message);
+                return;
+            }
+            static_cast<void>(consumer->Connect());
+            uint64_t packet {};
+            for (uint64_t i = 0; i < messages_per_consumer; ++i) {
+                if (not consumer->Receive(packet).has_value()) {
+                    return;
+                }
+            }
+            success[consumer_index] = 1;
+        });
+    }
+    for (auto& thread : consumer_threads) {
+        thread.join();
+    }
+    auto const elapsed_ns = timer.ElapsedDurationNs();
+    for (auto const consumer_success : success) {
+        if (consumer_success == 0) {
+            return false;
+        }
+    }
+    ReportThroughput(name, message_count, elapsed_ns);
+    return true;
+}
+
+static auto RunProducers(
+    pika::ChannelParameters const& params, uint64_t producer_count, uint64_t message_count) -> bool
+{
+    // Keeps the channel alive until the consumers have drained it
+    auto anchor = pika::Channel::CreateProducer<uint64_t>(params);
+    if (not anchor.has_value()) {
+        fmt::println(stderr, "{}", anchor.error().error_message);
+        return false;
+    }
+    auto const messages_per_producer = message_count / producer_count;
+    std::vector<std::thread> producer_threads;
+    for (uint64_t producer_index = 0; producer_index < producer_count; ++producer_index) {
+        producer_threads.emplace_back([&]() {
+            auto producer = pika::Channel::CreateProducer<uint64_t>(params);
+            if (not producer.has_value()) {
+                fmt::println(stderr, "{}", producer.error().error_message);
+                return;
+            }
+            static_cast<void>(producer->Connect());
+            for (uint64_t packet = 0; packet < messages_per_producer; ++packet) {
+                if (not producer->Send(packet).has_value()) {
+                    return;
+                }
+            }
+        });
+    }
+    for (auto& thread : producer_threads) {
+        thread.join();
+    }
+    while (anchor->IsConnected()) {
+        std::this_thread::yield();
+    }
+    auto const statistics = anchor->GetWakeupStatistics();
+    if (statistics.signals_sent + statistics.signals_skipped != 0) {
+        fmt::println("{:<48} {:>12} signals sent {:>10} skipped", "", statistics.signals_sent,
+            statistics.signals_skipped);
+        std::fflush(stdout);
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    // A multiple of every thread count below
+    auto const message_count = static_cast<uint64_t>(GetArgument(argc, argv, 1, 4'000'000));
+    struct Configuration {
+        uint64_t producer_count;
+        uint64_t consumer_count;
+    };
+    auto const configurations
+        = std::vector<Configuration> { { 1, 1 }, { 4, 1 }, { 1, 4 }, { 4, 4 } };
+    struct Mode {
+        pika::QueueMode queue_mode;
+        bool futex_mutex_mode;
+        char const* name;
+    };
+    auto const modes
+        = std::vector<Mode> { { pika::QueueMode::LockProtected, false, "LockProtected" },
+              { pika::QueueMode::LockProtected, true, "LockProtected(futex)" },
+              { pika::QueueMode::TwoLock, false, "TwoLock" } };
+
+    for (auto const& mode : modes) {
+        for (auto const& configuration : configurations) {
+            auto params = pika::ChannelParameters { .channel_name = "/bench_lock_contention",
+                .queue_size = 1024,
+                .channel_type = pika::ChannelType::InterThread,
+                .queue_mode = mode.queue_mode,
+                .futex_mutex_mode = mode.futex_mutex_mode };
+            auto const name = fmt::format("{} {}x{}", mode.name, configuration.producer_count,
+                configuration.consumer_count);
+            {
+                auto consumer_thread = std::thread([&]() {
+                    RunConsumers(params, configuration.consumer_count, message_count,
+                        name + " inter-thread");
+                });
+                RunProducers(params, configuration.producer_count, message_count);
+                consumer_thread.join();
+            }
+
+            params.channel_type = pika::ChannelType::InterProcess;
+            auto child_process_handle
+                = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+                      return RunConsumers(params, configuration.consumer_count, message_count,
+                                 name + " inter-process")
+                          ? ChildProcessState::SUCCESS
+                          : ChildProcessState::FAIL;
+                  });
+            if (not child_process_handle.has_value()) {
+                fmt::println(stderr, "{}", child_process_handle.error().error_message);
+                return 1;
+            }
+            RunProducers(params, configuration.producer_count, message_count);
+            if (not child_process_handle->WaitForChildProcess().has_value()) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
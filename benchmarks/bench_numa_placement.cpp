@@ -0,0 +1,136 @@
+// Throughput of a large channel whose producer and consumer run on different NUMA nodes, for
+// each placement of the channel's memory.
+// Usage: bench_numa_placement [queue_megabytes] [sweep_count]
+// The producer runs on the first CPU of the first node and creates the channel, the consumer
+// runs on the first CPU of the last node. Every message is written on one node and read on the
+// other, the placement decides which side pays for the remote accesses. On single node machines
+// all placements are equivalent.
+#include "bench_utils.hpp"
+#include "channel_interface.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <fmt/core.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Message {
+    uint64_t sequence_number;
+    uint8_t payload[56];
+};
+
+struct NumaNode {
+    int32_t node;
+    int first_cpu;
+};
+
+// Nodes with at least one CPU
+static auto GetNumaNodes() -> std::vector<NumaNode>
+{
+    std::vector<NumaNode> nodes;
+    for (int32_t node = 0; node < 1024; ++node) {
+        auto const path = fmt::format("/sys/devices/system/node/node{}/cpulist", node);
+        auto file = std::fopen(path.c_str(), "r");
+        if (file == nullptr) {
+            continue;
+        }
+        int first_cpu = -1;
+        if (std::fscanf(file, "%d", &first_cpu) == 1) {
+            nodes.push_back({ node, first_cpu });
+        }
+        std::fclose(file);
+    }
+    if (nodes.empty()) {
+        nodes.push_back({ 0, -1 });
+    }
+    return nodes;
+}
+
+static auto RunTransfer(pika::ChannelParameters const& params, std::string const& name,
+    NumaNode producer_node, NumaNode consumer_node, uint64_t message_count) -> bool
+{
+    PinCurrentThreadToCore(producer_node.first_cpu);
+    auto producer = pika::Channel::CreateProducer<Message>(params);
+    if (not producer.has_value()) {
+        fmt::println(stderr, "{}", producer.error().error_message);
+        return false;
+    }
+    auto consumer_success = false;
+    auto placed_node = int32_t { -1 };
+    BenchTimer timer;
+    auto consumer_thread = std::thread([&]() {
+        PinCurrentThreadToCore(consumer_node.first_cpu);
+        auto consumer = pika::Channel::CreateConsumer<Message>(params);
+        if (not consumer.has_value()) {
+            fmt::println(stderr, "{}", consumer.error().error_message);
+            return;
+        }
+        placed_node = consumer->GetSegmentBacking().numa_node;
+        auto message = Message {};
+        for (uint64_t i = 0; i < message_count; ++i) {
+            if (not consumer->Receive(message).has_value() || message.sequence_number != i) {
+                return;
+            }
+        }
+        consumer_success = true;
+    });
+    auto message = Message {};
+    for (uint64_t i = 0; i < message_count; ++i) {
+        message.sequence_number = i;
+        if (not producer->Send(message).has_value()) {
+            break;
+        }
+    }
+    consumer_thread.join();
+    auto const elapsed_ns = timer.ElapsedDurationNs();
+    if (not consumer_success) {
+        return false;
+    }
+    ReportThroughput(fmt::format("{} (node {})", name,
+                         placed_node == -1 ? std::string("-") : std::to_string(placed_node)),
+        message_count, elapsed_ns);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    auto const queue_bytes = static_cast<uint64_t>(GetArgument(argc, argv, 1, 64)) << 20;
+    auto const sweep_count = static_cast<uint64_t>(GetArgument(argc, argv, 2, 8));
+    auto const queue_size = queue_bytes / sizeof(Message);
+
+    auto const nodes = GetNumaNodes();
+    auto const producer_node = nodes.front();
+    auto const consumer_node = nodes.back();
+    fmt::println("Producer on node {} (cpu {}), consumer on node {} (cpu {})", producer_node.node,
+        producer_node.first_cpu, consumer_node.node, consumer_node.first_cpu);
+    if (nodes.size() == 1) {
+        fmt::println("Single NUMA node, all placements are equivalent");
+    }
+    struct Placement {
+        pika::NumaPolicy numa_policy;
+        int32_t numa_node;
+        char const* name;
+    };
+    auto const placements = std::vector<Placement> {
+        { pika::NumaPolicy::Default, 0, "First touch by the producer" },
+        { pika::NumaPolicy::Bind, producer_node.node, "Bound to the producer's node" },
+        { pika::NumaPolicy::Bind, consumer_node.node, "Bound to the consumer's node" },
+        { pika::NumaPolicy::Interleave, 0, "Interleaved" },
+        { pika::NumaPolicy::FollowConsumer, 0, "Following the consumer" },
+    };
+    for (auto const& placement : placements) {
+        auto const params = pika::ChannelParameters { .channel_name = "/bench_numa_placement",
+            .queue_size = queue_size,
+            .channel_type = pika::ChannelType::InterProcess,
+            .single_producer_single_consumer_mode = true,
+            .prefault_mode = placement.numa_policy != pika::NumaPolicy::FollowConsumer,
+            .numa_policy = placement.numa_policy,
+            .numa_node = placement.numa_node };
+        if (not RunTransfer(params, placement.name, producer_node, consumer_node,
+                queue_size * sweep_count)) {
+            return 1;
+        }
+    }
+    return 0;
+}
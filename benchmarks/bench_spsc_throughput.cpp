@@ -0,0 +1,92 @@
+// Cross-core throughput of the single producer single consumer lock-free channel.
+// Usage: bench_spsc_throughput [message_count] [producer_core] [consumer_core]
+// Pin the producer and the consumer to different physical cores to measure the cost of the
+// cache line traffic between them.
+#include "bench_utils.hpp"
+#include "channel_interface.hpp"
+#include "process_fork.hpp"
+
+#include <cstdint>
+#include <fmt/core.h>
+#include <thread>
+
+static auto RunConsumer(pika::ChannelParameters const& params, uint64_t message_count,
+    int consumer_core) -> bool
+{
+    PinCurrentThreadToCore(consumer_core);
+    auto consumer = pika::Channel::CreateConsumer<uint64_t>(params);
+    if (not consumer.has_value()) {
+        fmt::println(stderr, "{}", consumer.error().error_message);
+        return false;
+    }
+    static_cast<void>(consumer->Connect());
+    uint64_t packet {};
+    static_cast<void>(consumer->Receive(packet));
+    BenchTimer timer;
+    for (uint64_t expected = 1; expected < message_count; ++expected) {
+        auto result = consumer->Receive(packet);
+        if (not result.has_value() || packet != expected) {
+            fmt::println(stderr, "Unexpected packet {} (expected {})", packet, expected);
+            return false;
+        }
+    }
+    auto const elapsed_ns = timer.ElapsedDurationNs();
+    ReportThroughput(params.channel_type == pika::ChannelType::InterThread
+            ? "SPSC inter-thread"
+            : "SPSC inter-process",
+        message_count - 1, elapsed_ns);
+    return true;
+}
+
+static auto RunProducer(
+    pika::ChannelParameters const& params, uint64_t message_count, int producer_core) -> bool
+{
+    PinCurrentThreadToCore(producer_core);
+    auto producer = pika::Channel::CreateProducer<uint64_t>(params);
+    if (not producer.has_value()) {
+        fmt::println(stderr, "{}", producer.error().error_message);
+        return false;
+    }
+    static_cast<void>(producer->Connect());
+    for (uint64_t packet = 0; packet < message_count; ++packet) {
+        if (not producer->Send(packet).has_value()) {
+            return false;
+        }
+    }
+    // Keep the channel alive until the consumer has drained it
+    while (producer->IsConnected()) {
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    auto const message_count = static_cast<uint64_t>(GetArgument(argc, argv, 1, 10'000'000));
+    auto const producer_core = static_cast<int>(GetArgument(argc, argv, 2, 0));
+    auto const consumer_core = static_cast<int>(GetArgument(argc, argv, 3, 1));
+
+    auto params = pika::ChannelParameters { .channel_name = "/bench_spsc_throughput",
+        .queue_size = 1024,
+        .channel_type = pika::ChannelType::InterThread,
+        .single_producer_single_consumer_mode = true };
+    {
+        auto consumer_thread = std::thread([&]() {
+            RunConsumer(params, message_count, consumer_core);
+        });
+        RunProducer(params, message_count, producer_core);
+        consumer_thread.join();
+    }
+
+    params.channel_type = pika::ChannelType::InterProcess;
+    auto child_process_handle = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+        return RunConsumer(params, message_count, consumer_core) ? ChildProcessState::SUCCESS
+                                                                 : ChildProcessState::FAIL;
+    });
+    if (not child_process_handle.has_value()) {
+        fmt::println(stderr, "{}", child_process_handle.error().error_message);
+        return 1;
+    }
+    RunProducer(params, message_count, producer_core);
+    return child_process_handle->WaitForChildProcess().has_value() ? 0 : 1;
+}
@@ -0,0 +1,121 @@
+#ifndef PIKA_BENCH_UTILS_HPP
+#define PIKA_BENCH_UTILS_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sched.h>
+#include <string_view>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Pins the calling thread to the given core, negative values leave the affinity untouched
+auto inline PinCurrentThreadToCore(int core) -> bool
+{
+    if (core < 0) {
+        return true;
+    }
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    CPU_SET(static_cast<size_t>(core), &cpu_set);
+    auto const return_code = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (return_code != 0) {
+        fmt::println(stderr, "pthread_setaffinity_np({}) failed with error code:{}", core,
+            return_code);
+        return false;
+    }
+    return true;
+}
+
+auto inline GetArgument(int argc, char** argv, int index, int64_t default_value) -> int64_t
+{
+    if (index < argc) {
+        return std::strtoll(argv[index], nullptr, 10);
+    }
+    return default_value;
+}
+
+class BenchTimer {
+    using Clock = std::chrono::steady_clock;
+    Clock::time_point start_point;
+
+public:
+    BenchTimer()
+        : start_point(Clock::now())
+    {
+    }
+    auto ElapsedDurationNs() const -> int64_t
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start_point)
+            .count();
+    }
+};
+
+// Counts a hardware event on the calling thread in user mode. Perf events are often unavailable
+// in containers and virtual machines, IsAvailable tells.
+class PerfCounter {
+    int m_fd = -1;
+
+public:
+    PerfCounter(uint32_t type, uint64_t config)
+    {
+        perf_event_attr attributes {};
+        attributes.size = sizeof(attributes);
+        attributes.type = type;
+        attributes.config = config;
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        m_fd = static_cast<int>(syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0));
+    }
+    PerfCounter(PerfCounter const&) = delete;
+    ~PerfCounter()
+    {
+        if (m_fd != -1) {
+            close(m_fd);
+        }
+    }
+    static auto DataTlbReadMisses() -> PerfCounter
+    {
+        return PerfCounter(PERF_TYPE_HW_CACHE,
+            PERF_COUNT_HW_CACHE_DTLB | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    }
+    auto IsAvailable() const -> bool { return m_fd != -1; }
+    auto Start() -> void
+    {
+        if (m_fd != -1) {
+            ioctl(m_fd, PERF_EVENT_IOC_RESET, 0);
+            ioctl(m_fd, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+    auto Stop() -> uint64_t
+    {
+        uint64_t count = 0;
+        if (m_fd != -1) {
+            ioctl(m_fd, PERF_EVENT_IOC_DISABLE, 0);
+            if (read(m_fd, &count, sizeof(count)) != sizeof(count)) {
+                count = 0;
+            }
+        }
+        return count;
+    }
+};
+
+auto inline ReportThroughput(std::string_view name, uint64_t message_count, int64_t elapsed_ns)
+    -> void
+{
+    auto const seconds = static_cast<double>(elapsed_ns) / 1e9;
+    fmt::println("{:<48} {:>12.0f} msgs/s {:>10.2f} ns/msg", name,
+        static_cast<double>(message_count) / seconds,
+        static_cast<double>(elapsed_ns) / static_cast<double>(message_count));
+    // Forked children exit through _exit which does not flush stdio buffers
+    std::fflush(stdout);
+}
+
+#endif
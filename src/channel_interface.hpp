@@ -26,10 +26,13 @@
 #include "error.hpp"
 
 #include <__expected/unexpected.h>
+#include <cstddef>
 #include <cstdint>
 #include <expected>
 #include <limits>
 #include <memory>
+#include <span>
+#include <string>
 #include <type_traits>
 
 namespace pika {
@@ -40,6 +43,46 @@ concept ChannelPacketType = std::is_pod_v<T>;
 using DurationUs = uint64_t;
 static constexpr DurationUs INFINITE_TIMEOUT = std::numeric_limits<DurationUs>::max();
 
+// Wakeups issued by the blocking operations of a channel. Only channels in the LockProtected
+// queue mode count them, the counters are shared by all endpoints of the channel.
+struct WakeupStatistics {
+    uint64_t signals_sent = 0; // Condition variable signals and broadcasts issued
+    uint64_t signals_skipped = 0; // Signals not issued because nobody was waiting
+};
+
+// Pages backing the memory segment of a channel. Huge pages cover a large ring with far fewer TLB
+// entries than 4 KB pages.
+enum class HugePageMode {
+    None, // Regular pages
+    // Memory mapped at a huge page aligned address and advised with MADV_HUGEPAGE. Depends on
+    // /sys/kernel/mm/transparent_hugepage/shmem_enabled(inter-process) or enabled(inter-thread)
+    // allowing it.
+    Transparent,
+    // File on a hugetlbfs mount(inter-process) or MAP_HUGETLB memory(inter-thread), backed by
+    // huge pages reserved by the administrator (vm.nr_hugepages). The segment is sized up to a
+    // multiple of the huge page size.
+    Explicit
+};
+
+// Placement of the memory segment of a channel on the NUMA nodes of the machine
+enum class NumaPolicy {
+    Default, // Pages are placed on the node of the thread that first touches them
+    Bind, // Pages are placed on numa_node only
+    Interleave, // Pages are spread round-robin over all nodes the process may allocate on
+    // Pages are preferably placed on the node of the first consumer, pages placed before it was
+    // created are migrated where possible
+    FollowConsumer
+};
+
+struct SegmentBacking {
+    HugePageMode huge_page_mode = HugePageMode::None; // Mode in effect
+    uint64_t page_size = 0; // Size of the pages in effect
+    // Set when the requested huge page mode could not be used and the segment fell back to
+    // regular pages
+    std::string fallback_reason;
+    int32_t numa_node = -1; // Node the segment is placed on, -1 unless bound to a single node
+};
+
 struct ProducerImpl {
     virtual ~ProducerImpl() = default;
     virtual auto Connect() -> std::expected<void, PikaError> = 0;
@@ -50,7 +93,21 @@ struct ProducerImpl {
         -> std::expected<uint8_t* const, PikaError>
         = 0;
     virtual auto ReleaseSendSlot(uint8_t* slot) -> std::expected<void, PikaError> = 0;
+    virtual auto SendBatch(uint8_t const* const source_buffer, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+        = 0;
+    // Only supported on byte stream channels
+    virtual auto SendBytes(uint8_t const* const source_buffer, uint64_t size,
+        DurationUs timeout_duration) -> std::expected<void, PikaError>
+        = 0;
+    virtual auto ReserveBytes(uint64_t size, DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError>
+        = 0;
+    virtual auto CommitBytes(uint8_t const* const reservation) -> std::expected<void, PikaError>
+        = 0;
     virtual auto IsConnected() -> bool = 0;
+    virtual auto GetWakeupStatistics() -> WakeupStatistics = 0;
+    virtual auto GetSegmentBacking() -> SegmentBacking = 0;
 };
 
 struct ConsumerImpl {
@@ -64,15 +121,59 @@ struct ConsumerImpl {
         = 0;
     virtual auto ReleaseReceiveSlot(uint8_t const* const slot) -> std::expected<void, PikaError>
         = 0;
+    virtual auto ReceiveBatch(uint8_t* const destination_buffer, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+        = 0;
+    // Only supported on byte stream channels
+    virtual auto ReceiveBytes(uint8_t* const destination_buffer, uint64_t destination_size,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+        = 0;
+    // Sequence number of the last value received on a conflating channel
+    virtual auto GetSequenceNumber() -> uint64_t = 0;
+    virtual auto GetReceiveBytes(DurationUs timeout_duration)
+        -> std::expected<std::span<uint8_t const>, PikaError>
+        = 0;
+    virtual auto ReleaseReceiveBytes(uint8_t const* const record)
+        -> std::expected<void, PikaError>
+        = 0;
     virtual auto IsConnected() -> bool = 0;
+    virtual auto GetWakeupStatistics() -> WakeupStatistics = 0;
+    virtual auto GetSegmentBacking() -> SegmentBacking = 0;
 };
 
+// Endpoints created together on one unnamed segment
+struct EndpointPairImpl {
+    std::unique_ptr<ProducerImpl> producer;
+    std::unique_ptr<ConsumerImpl> consumer;
+};
+
+namespace detail {
+// The non-blocking operations are the blocking ones with a zero timeout. Their Timeout becomes a
+// WouldBlock error, both messages are string literals so neither allocates.
+template <typename ResultT>
+auto TimeoutToWouldBlock(std::expected<ResultT, PikaError>&& result)
+    -> std::expected<ResultT, PikaError>
+{
+    if (not result.has_value() and result.error().error_type == PikaErrorType::Timeout) {
+        return std::unexpected(PikaError {
+            .error_type = PikaErrorType::WouldBlock, .error_message = "Operation would block" });
+    }
+    return std::move(result);
+}
+} // namespace detail
+
 template <ChannelPacketType DataT> struct Producer {
     auto Send(DataT const& packet, DurationUs timeout_duration = INFINITE_TIMEOUT)
         -> std::expected<void, PikaError>
     {
         return m_impl->Send(reinterpret_cast<uint8_t const*>(&packet), timeout_duration);
     }
+    // Sends the packet only if that does not require waiting, for a free slot or for another
+    // endpoint holding the channel lock. Fails with a WouldBlock error otherwise.
+    auto TrySend(DataT const& packet) -> std::expected<void, PikaError>
+    {
+        return detail::TimeoutToWouldBlock(Send(packet, 0));
+    }
     auto GetSendSlot(DurationUs timeout_duration = INFINITE_TIMEOUT)
         -> std::expected<DataT*, PikaError>
     {
@@ -86,6 +187,23 @@ template <ChannelPacketType DataT> struct Producer {
     {
         return m_impl->ReleaseSendSlot(reinterpret_cast<uint8_t* const>(slot));
     }
+    // Sends the packets in as few publishes as possible. Returns the number of packets sent,
+    // which is less than packets.size() only if the timeout expired after some packets were
+    // sent. Fails with a Timeout error if none could be sent.
+    auto SendBatch(std::span<DataT const> packets, DurationUs timeout_duration = INFINITE_TIMEOUT)
+        -> std::expected<uint64_t, PikaError>
+    {
+        return m_impl->SendBatch(
+            reinterpret_cast<uint8_t const*>(packets.data()), packets.size(), timeout_duration);
+    }
+    // Sends as many packets as fit without waiting. Fails with a WouldBlock error if none do.
+    auto TrySendBatch(std::span<DataT const> packets) -> std::expected<uint64_t, PikaError>
+    {
+        return detail::TimeoutToWouldBlock(SendBatch(packets, 0));
+    }
+
+    auto GetWakeupStatistics() -> WakeupStatistics { return m_impl->GetWakeupStatistics(); }
+    auto GetSegmentBacking() -> SegmentBacking { return m_impl->GetSegmentBacking(); }
 
     auto Connect() -> std::expected<void, PikaError> { return m_impl->Connect(); }
     auto IsConnected() -> bool { return m_impl->IsConnected(); }
@@ -105,6 +223,12 @@ template <ChannelPacketType DataT> struct Consumer {
     {
         return m_impl->Receive(reinterpret_cast<uint8_t*>(&packet), timeout_duration);
     }
+    // Receives a packet only if that does not require waiting, for a packet or for another
+    // endpoint holding the channel lock. Fails with a WouldBlock error otherwise.
+    auto TryReceive(DataT& packet) -> std::expected<void, PikaError>
+    {
+        return detail::TimeoutToWouldBlock(Receive(packet, 0));
+    }
 
     auto GetReceiveSlot(DurationUs timeout_duration = INFINITE_TIMEOUT)
         -> std::expected<DataT const* const, PikaError>
@@ -121,6 +245,28 @@ template <ChannelPacketType DataT> struct Consumer {
         return m_impl->ReleaseReceiveSlot(reinterpret_cast<uint8_t const* const>(packet_pointer));
     }
 
+    // Waits for at least min_count packets and receives up to packets.size() of them. Returns
+    // the number of packets received.
+    auto ReceiveBatch(std::span<DataT> packets, uint64_t min_count = 1,
+        DurationUs timeout_duration = INFINITE_TIMEOUT) -> std::expected<uint64_t, PikaError>
+    {
+        return m_impl->ReceiveBatch(reinterpret_cast<uint8_t*>(packets.data()), packets.size(),
+            min_count, timeout_duration);
+    }
+    // Receives the packets available without waiting, up to packets.size(). Fails with a
+    // WouldBlock error if there are none.
+    auto TryReceiveBatch(std::span<DataT> packets) -> std::expected<uint64_t, PikaError>
+    {
+        return detail::TimeoutToWouldBlock(ReceiveBatch(packets, 1, 0));
+    }
+
+    // Conflating channels number values from 1 in publish order. Returns the sequence number of
+    // the last value received, a gap to the previous one means values were conflated away.
+    auto GetSequenceNumber() -> uint64_t { return m_impl->GetSequenceNumber(); }
+
+    auto GetWakeupStatistics() -> WakeupStatistics { return m_impl->GetWakeupStatistics(); }
+    auto GetSegmentBacking() -> SegmentBacking { return m_impl->GetSegmentBacking(); }
+
     auto Connect() -> std::expected<void, PikaError> { return m_impl->Connect(); }
     auto IsConnected() -> bool { return m_impl->IsConnected(); }
 
@@ -133,20 +279,200 @@ private:
     std::unique_ptr<ConsumerImpl> m_impl;
 };
 
-enum class ChannelType { InterProcess, InterThread };
+// Producer of variable length messages on a byte stream channel
+struct ByteProducer {
+    auto SendBytes(std::span<std::byte const> message,
+        DurationUs timeout_duration = INFINITE_TIMEOUT) -> std::expected<void, PikaError>
+    {
+        return m_impl->SendBytes(
+            reinterpret_cast<uint8_t const*>(message.data()), message.size(), timeout_duration);
+    }
+
+    // Reserves size contiguous bytes in the channel to be written in place, the message is
+    // published by CommitBytes
+    auto ReserveBytes(uint64_t size, DurationUs timeout_duration = INFINITE_TIMEOUT)
+        -> std::expected<std::span<std::byte>, PikaError>
+    {
+        auto result = m_impl->ReserveBytes(size, timeout_duration);
+        if (not result.has_value()) {
+            return std::unexpected(result.error());
+        }
+        return std::span<std::byte>(reinterpret_cast<std::byte*>(result.value()), size);
+    }
+
+    auto CommitBytes(std::span<std::byte> reservation) -> std::expected<void, PikaError>
+    {
+        return m_impl->CommitBytes(reinterpret_cast<uint8_t const*>(reservation.data()));
+    }
+
+    auto Connect() -> std::expected<void, PikaError> { return m_impl->Connect(); }
+    auto IsConnected() -> bool { return m_impl->IsConnected(); }
+    auto GetSegmentBacking() -> SegmentBacking { return m_impl->GetSegmentBacking(); }
+
+private:
+    friend struct Channel;
+    ByteProducer(std::unique_ptr<ProducerImpl> impl)
+        : m_impl(std::move(impl))
+    {
+    }
+    std::unique_ptr<ProducerImpl> m_impl;
+};
+
+// Consumer of variable length messages on a byte stream channel
+struct ByteConsumer {
+    // Receives the next message into buffer and returns its size. A message that does not fit in
+    // buffer is left in the channel and an error is returned.
+    auto ReceiveBytes(std::span<std::byte> buffer, DurationUs timeout_duration = INFINITE_TIMEOUT)
+        -> std::expected<uint64_t, PikaError>
+    {
+        return m_impl->ReceiveBytes(
+            reinterpret_cast<uint8_t*>(buffer.data()), buffer.size(), timeout_duration);
+    }
+
+    // Zero-copy access to the next message, which stays in the channel until
+    // ReleaseReceiveBytes is called
+    auto GetReceiveBytes(DurationUs timeout_duration = INFINITE_TIMEOUT)
+        -> std::expected<std::span<std::byte const>, PikaError>
+    {
+        auto result = m_impl->GetReceiveBytes(timeout_duration);
+        if (not result.has_value()) {
+            return std::unexpected(result.error());
+        }
+        return std::as_bytes(*result);
+    }
+
+    auto ReleaseReceiveBytes(std::span<std::byte const> message) -> std::expected<void, PikaError>
+    {
+        return m_impl->ReleaseReceiveBytes(reinterpret_cast<uint8_t const*>(message.data()));
+    }
+
+    auto Connect() -> std::expected<void, PikaError> { return m_impl->Connect(); }
+    auto IsConnected() -> bool { return m_impl->IsConnected(); }
+    auto GetSegmentBacking() -> SegmentBacking { return m_impl->GetSegmentBacking(); }
+
+private:
+    friend struct Channel;
+    ByteConsumer(std::unique_ptr<ConsumerImpl> impl)
+        : m_impl(std::move(impl))
+    {
+    }
+    std::unique_ptr<ConsumerImpl> m_impl;
+};
+
+enum class ChannelType {
+    InterProcess,
+    InterThread,
+    // Inter-process channel on a memfd created by Channel::CreateAnonymousChannel. Touches no
+    // global namespace: the memory is found through ChannelParameters::channel_fd, which forked
+    // processes inherit and unrelated processes receive with Channel::ReceiveChannelFd. The
+    // memory is released once the last descriptor and endpoint are gone, even after a crash.
+    AnonymousInterProcess
+};
+
+// Selects the queue implementation used when single_producer_single_consumer_mode is not set
+enum class QueueMode {
+    LockProtected, // Single lock shared by all producers and consumers
+    LockFree, // Bounded lock-free multi-producer multi-consumer queue
+    // Single producer, every message is delivered to every consumer. The producer is gated by the
+    // slowest consumer.
+    Broadcast,
+    // Single producer, consumers only receive the latest value. The producer never blocks and
+    // queue_size is the number of seqlock protected slots the values rotate through.
+    Conflating,
+    // Single producer single consumer triple buffer for large elements of which only the latest
+    // matters. Neither side ever blocks on the other; GetSendSlot/GetReceiveSlot give in-place
+    // access to the elements. queue_size is ignored.
+    TripleBuffer,
+    // Multi producer single consumer channel where every producer pushes into its own single
+    // producer single consumer lane of queue_size slots; the consumer drains the lanes
+    // round-robin. Producers never contend with each other.
+    ProducerLanes,
+    // Like LockProtected but with separate producer and consumer locks, producers only contend
+    // with producers and consumers only with consumers
+    TwoLock
+};
+
+// How a lock-free single producer single consumer endpoint waits for the ring buffer to become
+// non-full/non-empty
+enum class WaitStrategyType {
+    BusySpin, // Poll continuously, lowest latency but occupies a core while waiting
+    SpinPause, // Poll with a CPU pause hint in between, friendlier to a sibling hyper-thread
+    SpinYield, // Poll spin_budget times, then yield the core between polls
+    SpinPark // Poll spin_budget times, then park the thread on a futex between polls
+};
+
+struct WaitStrategy {
+    WaitStrategyType type = WaitStrategyType::BusySpin;
+    uint64_t spin_budget = 1024; // Polls before yielding/parking
+    // Upper bound on a single park. Parked threads are woken as soon as the other side
+    // publishes, so this only bounds the damage of a missed wakeup.
+    DurationUs max_park_duration = INFINITE_TIMEOUT;
+    auto operator==(WaitStrategy const&) const -> bool = default;
+};
 
 struct ChannelParameters {
     std::string channel_name;
     uint64_t queue_size {};
     ChannelType channel_type;
     bool single_producer_single_consumer_mode = false;
+    QueueMode queue_mode = QueueMode::LockProtected;
+    // Rounds queue_size up to the next power of two so that slots are indexed with a mask
+    bool power_of_two_capacity_mode = false;
+    WaitStrategy wait_strategy {};
+    // Byte stream channels only: maps the ring twice back to back so that records can cross the
+    // end of the ring and still be accessed through a single pointer. Inter-process channels
+    // only; queue_size is rounded up to a multiple of the page size.
+    bool mirrored_mapping_mode = false;
+    // LockProtected queue mode only: protects the ring with a spin-then-park futex mutex instead
+    // of a pthread mutex
+    bool futex_mutex_mode = false;
+    // All endpoints of a channel must request the same mode. Falls back to regular pages when
+    // huge pages are not available, GetSegmentBacking reports why.
+    // Not supported together with mirrored_mapping_mode.
+    HugePageMode huge_page_mode = HugePageMode::None;
+    // Faults every page of the channel's memory in when the endpoint is created, so that the
+    // first messages do not take page faults. Pages are placed on the NUMA node of the endpoint
+    // that faults them in first; creating the consumer first keeps the ring local to it.
+    bool prefault_mode = false;
+    // Locks the channel's memory (mlock) for the lifetime of the endpoint, subject to
+    // RLIMIT_MEMLOCK
+    bool lock_memory_mode = false;
+    // All endpoints of a channel must request the same policy. Pages an endpoint of another
+    // process has already mapped cannot be migrated, combine FollowConsumer with prefault_mode
+    // only on the consumer.
+    NumaPolicy numa_policy = NumaPolicy::Default;
+    int32_t numa_node = 0; // NumaPolicy::Bind only
+    // ChannelType::AnonymousInterProcess only, descriptor returned by CreateAnonymousChannel.
+    // Endpoints keep their own duplicate, the caller may close it once they are created.
+    int32_t channel_fd = -1;
+};
+
+// Connected endpoints of a channel created by Channel::CreatePair
+template <ChannelPacketType DataT> struct ChannelPair {
+    Producer<DataT> producer;
+    Consumer<DataT> consumer;
 };
 
 struct Channel {
+    // Creates the memory of an anonymous channel and returns its descriptor(close-on-exec). With
+    // HugePageMode::Explicit the memory is backed by huge pages if the kernel supports them.
+    static auto CreateAnonymousChannel(HugePageMode huge_page_mode = HugePageMode::None)
+        -> std::expected<int32_t, PikaError>;
+    // Pass the descriptor of an anonymous channel over a connected Unix domain socket
+    static auto SendChannelFd(int32_t socket_fd, int32_t channel_fd)
+        -> std::expected<void, PikaError>;
+    static auto ReceiveChannelFd(int32_t socket_fd) -> std::expected<int32_t, PikaError>;
+
     static auto __CreateProducerImpl(ChannelParameters const& channel_params, uint64_t element_size,
         uint64_t element_alignment) -> std::expected<std::unique_ptr<ProducerImpl>, PikaError>;
     static auto __CreateConsumerImpl(ChannelParameters const& channel_params, uint64_t element_size,
         uint64_t element_alignment) -> std::expected<std::unique_ptr<ConsumerImpl>, PikaError>;
+    static auto __CreatePairImpl(ChannelParameters const& channel_params, uint64_t element_size,
+        uint64_t element_alignment) -> std::expected<std::unique_ptr<EndpointPairImpl>, PikaError>;
+    static auto __CreateByteProducerImpl(ChannelParameters const& channel_params)
+        -> std::expected<std::unique_ptr<ProducerImpl>, PikaError>;
+    static auto __CreateByteConsumerImpl(ChannelParameters const& channel_params)
+        -> std::expected<std::unique_ptr<ConsumerImpl>, PikaError>;
 
     template <ChannelPacketType DataT>
     static auto CreateProducer(ChannelParameters const& channel_params)
@@ -194,6 +520,50 @@ struct Channel {
             return std::unexpected(impl.error());
         }
     }
+
+    // Creates a connected producer and consumer of an inter-thread channel without going through
+    // the channel registry, channel_name is ignored. The channel lives as long as either endpoint
+    // and cannot be joined by further endpoints. Cheaper than CreateProducer and CreateConsumer
+    // for short-lived channels.
+    template <ChannelPacketType DataT>
+    static auto CreatePair(ChannelParameters const& channel_params)
+        -> std::expected<ChannelPair<DataT>, PikaError>
+    {
+        auto impl = __CreatePairImpl(channel_params, sizeof(DataT), alignof(DataT));
+        if (impl.has_value()) {
+            return ChannelPair<DataT> {
+                .producer = Producer<DataT> { std::move((*impl)->producer) },
+                .consumer = Consumer<DataT> { std::move((*impl)->consumer) },
+            };
+        } else {
+            return std::unexpected(impl.error());
+        }
+    }
+
+    // Byte stream channels carry variable length messages in a single producer single consumer
+    // ring of queue_size bytes(rounded up to a multiple of 8). Every message occupies its size
+    // plus an 8-byte length prefix, rounded up to a multiple of 8.
+    static auto CreateByteProducer(ChannelParameters const& channel_params)
+        -> std::expected<ByteProducer, PikaError>
+    {
+        auto impl = __CreateByteProducerImpl(channel_params);
+        if (impl.has_value()) {
+            return ByteProducer { std::move(*impl) };
+        } else {
+            return std::unexpected(impl.error());
+        }
+    }
+
+    static auto CreateByteConsumer(ChannelParameters const& channel_params)
+        -> std::expected<ByteConsumer, PikaError>
+    {
+        auto impl = __CreateByteConsumerImpl(channel_params);
+        if (impl.has_value()) {
+            return ByteConsumer { std::move(*impl) };
+        } else {
+            return std::unexpected(impl.error());
+        }
+    }
     Channel() = delete;
 };
 
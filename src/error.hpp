@@ -22,7 +22,12 @@
 #ifndef PIKA_ERROR_HPP
 #define PIKA_ERROR_HPP
 
+#include <cstddef>
+#include <fmt/core.h>
+#include <iosfwd>
 #include <string>
+#include <string_view>
+#include <utility>
 
 auto PrintAssertionMessage(
     char const* file, int line, char const* function_name, char const* message = nullptr) -> void;
@@ -45,12 +50,59 @@ enum class PikaErrorType {
     SyncPrimitiveError,
     RingBufferError,
     ChannelError,
-    Timeout
+    Timeout,
+    WouldBlock
+};
+
+// Message of a PikaError. A message built from a string literal only references the literal, so
+// the errors returned in steady state (timeouts, full or empty queues) never allocate. Messages
+// composed at runtime, or appended to, own their storage.
+class ErrorMessage {
+public:
+    ErrorMessage() = default;
+    template <std::size_t N>
+    ErrorMessage(char const (&literal)[N])
+        : m_literal(literal, N - 1)
+    {
+    }
+    // A writable array is a buffer rather than a literal and may not outlive the message, copy
+    // it into a std::string instead
+    template <std::size_t N> ErrorMessage(char (&buffer)[N]) = delete;
+    ErrorMessage(std::string message)
+        : m_owned(std::move(message))
+    {
+    }
+    [[nodiscard]] auto View() const -> std::string_view
+    {
+        return m_literal.data() != nullptr ? m_literal : std::string_view(m_owned);
+    }
+    auto Append(std::string_view suffix) -> void
+    {
+        if (m_literal.data() != nullptr) {
+            m_owned = std::string(m_literal);
+            m_literal = {};
+        }
+        m_owned.append(suffix);
+    }
+
+private:
+    std::string_view m_literal;
+    std::string m_owned;
+};
+
+auto operator<<(std::ostream& stream, ErrorMessage const& message) -> std::ostream&;
+
+template <> struct fmt::formatter<ErrorMessage> {
+    constexpr auto parse(fmt::format_parse_context& context) { return context.begin(); }
+    auto format(ErrorMessage const& message, fmt::format_context& context) const
+    {
+        return fmt::format_to(context.out(), "{}", message.View());
+    }
 };
 
 struct PikaError {
     PikaErrorType error_type = PikaErrorType::Unknown;
-    std::string error_message;
+    ErrorMessage error_message;
 };
 
 #endif
\ No newline at end of file
@@ -24,24 +24,278 @@
 // Local includes
 #include "error.hpp"
 // System includes
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <errno.h>
 #include <fcntl.h> /* For O_* constants */
 #include <fmt/core.h>
+#include <linux/magic.h>
+#include <linux/mempolicy.h>
+#include <mntent.h>
 #include <mutex>
+#include <new>
 #include <sys/mman.h>
 #include <sys/stat.h> /* For mode constants */
+#include <sys/syscall.h>
+#include <sys/vfs.h>
 #include <unistd.h>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
-auto InterProcessSharedBuffer::Initialize(std::string const& identifier, uint64_t size)
+static auto getPageSize() -> uint64_t { return static_cast<uint64_t>(sysconf(_SC_PAGESIZE)); }
+
+static auto roundUp(uint64_t value, uint64_t multiple) -> uint64_t
+{
+    return ((value + multiple - 1) / multiple) * multiple;
+}
+
+// First line of a sysfs file
+static auto readSysfsFile(char const* path) -> std::expected<std::string, PikaError>
+{
+    auto file = fopen(path, "r");
+    if (file == nullptr) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("Cannot read {}: {}", path, error_message) });
+    }
+    char line[256] {};
+    auto const read = fgets(line, sizeof(line), file) != nullptr;
+    fclose(file);
+    if (not read) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("{} is empty", path) });
+    }
+    return std::string(line);
+}
+
+// Size of the transparent huge pages that mappings advised with MADV_HUGEPAGE are backed by, or
+// why they are not. Shared memory and private anonymous memory are configured separately.
+static auto getTransparentHugePageSize(bool shared_memory) -> std::expected<uint64_t, PikaError>
+{
+    auto const enabled_path = shared_memory ? "/sys/kernel/mm/transparent_hugepage/shmem_enabled"
+                                            : "/sys/kernel/mm/transparent_hugepage/enabled";
+    // The setting in effect is the bracketed one, e.g. "always within_size [advise] never"
+    auto const enabled = readSysfsFile(enabled_path);
+    if (not enabled.has_value()) {
+        return std::unexpected(enabled.error());
+    }
+    auto const begin = enabled->find('[');
+    auto const end = enabled->find(']');
+    if (begin == std::string::npos || end == std::string::npos || end < begin) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("Cannot parse {}", enabled_path) });
+    }
+    auto const setting = enabled->substr(begin + 1, end - begin - 1);
+    if (setting == "never" || setting == "deny") {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("Transparent huge pages are disabled for {} memory, {} "
+                                         "is set to {}",
+                shared_memory ? "shared" : "anonymous", enabled_path, setting) });
+    }
+    auto const page_size = readSysfsFile("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size");
+    if (not page_size.has_value()) {
+        return std::unexpected(page_size.error());
+    }
+    return std::strtoull(page_size->c_str(), nullptr, 10);
+}
+
+// Size of the huge pages MAP_HUGETLB mappings are backed by
+static auto getDefaultHugePageSize() -> std::expected<uint64_t, PikaError>
+{
+    auto meminfo = fopen("/proc/meminfo", "r");
+    if (meminfo == nullptr) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("Cannot read /proc/meminfo: {}", error_message) });
+    }
+    Defer defer([meminfo]() { fclose(meminfo); });
+    char line[256] {};
+    while (fgets(line, sizeof(line), meminfo) != nullptr) {
+        unsigned long long size_kib = 0;
+        if (sscanf(line, "Hugepagesize: %llu kB", &size_kib) == 1) {
+            return static_cast<uint64_t>(size_kib) * 1024;
+        }
+    }
+    return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+        .error_message = "The kernel does not support huge pages" });
+}
+
+// Mount point of the first hugetlbfs file system
+static auto findHugeTlbfsMount() -> std::expected<std::string, PikaError>
+{
+    auto mounts = setmntent("/proc/mounts", "r");
+    if (mounts == nullptr) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("Cannot read /proc/mounts: {}", error_message) });
+    }
+    Defer defer([mounts]() { endmntent(mounts); });
+    while (auto const entry = getmntent(mounts)) {
+        if (std::string_view(entry->mnt_type) == "hugetlbfs") {
+            return std::string(entry->mnt_dir);
+        }
+    }
+    return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+        .error_message = "No hugetlbfs file system is mounted" });
+}
+
+// Write faults every page of [data, data + size) without changing its contents, other endpoints
+// may already be using them
+static auto prefaultRange(uint8_t* data, uint64_t size) -> std::expected<void, PikaError>
+{
+    auto const page_size = getPageSize();
+    if (reinterpret_cast<std::uintptr_t>(data) % page_size == 0) {
+        if (madvise(data, size, MADV_POPULATE_WRITE) == 0) {
+            return {};
+        }
+        if (errno != EINVAL) {
+            auto error_message = strerror(errno);
+            errno = 0;
+            return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+                .error_message
+                = fmt::format("madvise(MADV_POPULATE_WRITE) error: {}", error_message) });
+        }
+        // Kernels before 5.14 do not support MADV_POPULATE_WRITE
+        errno = 0;
+    }
+    for (uint64_t offset = 0; offset < size; offset += page_size) {
+        std::atomic_ref(data[offset]).fetch_add(0, std::memory_order_relaxed);
+    }
+    if (size != 0) {
+        // The range may end on a page the stride skipped over
+        std::atomic_ref(data[size - 1]).fetch_add(0, std::memory_order_relaxed);
+    }
+    return {};
+}
+
+static auto lockRange(uint8_t* data, uint64_t size) -> std::expected<void, PikaError>
+{
+    if (mlock(data, size) != 0) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("mlock of {} bytes failed with error: {}, see "
+                                         "RLIMIT_MEMLOCK",
+                size, error_message) });
+    }
+    return {};
+}
+
+// NUMA policies are set with raw system calls, so that libnuma is not needed
+static constexpr auto NUMA_NODE_MASK_BITS = uint64_t { 1024 };
+using NumaNodeMask = std::array<unsigned long, NUMA_NODE_MASK_BITS / (8 * sizeof(unsigned long))>;
+
+auto GetCurrentNumaNode() -> int32_t
+{
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) != 0) {
+        errno = 0;
+        return 0;
+    }
+    return static_cast<int32_t>(node);
+}
+
+static auto placeRange(uint8_t* data, uint64_t size, pika::NumaPolicy policy, int32_t node)
     -> std::expected<void, PikaError>
 {
-    if (m_data != nullptr) {
+    if (policy == pika::NumaPolicy::Default) {
+        return {};
+    }
+    NumaNodeMask allowed_nodes {};
+    if (syscall(SYS_get_mempolicy, nullptr, allowed_nodes.data(), NUMA_NODE_MASK_BITS + 1, nullptr,
+            MPOL_F_MEMS_ALLOWED)
+        != 0) {
+        auto error_message = strerror(errno);
+        errno = 0;
         return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
-            .error_message = "SharedBuffer::Initialize: Already initialized" });
+            .error_message = fmt::format("get_mempolicy error: {}", error_message) });
+    }
+    constexpr auto BITS_PER_WORD = 8 * sizeof(unsigned long);
+    NumaNodeMask node_mask {};
+    auto mode = int32_t { MPOL_INTERLEAVE };
+    if (policy == pika::NumaPolicy::Interleave) {
+        node_mask = allowed_nodes;
+    } else {
+        auto const node_index = static_cast<uint64_t>(node);
+        if (node < 0 || node_index >= NUMA_NODE_MASK_BITS
+            || (allowed_nodes[node_index / BITS_PER_WORD] & (1UL << (node_index % BITS_PER_WORD)))
+                == 0) {
+            return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+                .error_message = fmt::format("NUMA node {} does not exist or is not allowed for "
+                                             "this process",
+                    node) });
+        }
+        node_mask[node_index / BITS_PER_WORD] |= 1UL << (node_index % BITS_PER_WORD);
+        mode = policy == pika::NumaPolicy::Bind ? MPOL_BIND : MPOL_PREFERRED;
+    }
+    // Policies apply to whole pages
+    auto const page_size = getPageSize();
+    auto const begin = roundUp(reinterpret_cast<std::uintptr_t>(data), page_size);
+    auto const end = ((reinterpret_cast<std::uintptr_t>(data) + size) / page_size) * page_size;
+    if (begin >= end) {
+        return {};
+    }
+    if (syscall(SYS_mbind, begin, end - begin, mode, node_mask.data(), NUMA_NODE_MASK_BITS + 1,
+            MPOL_MF_MOVE)
+        != 0) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("mbind error: {}", error_message) });
+    }
+    return {};
+}
+
+// Maps size bytes of fd, or of private anonymous memory when fd is -1, at an address aligned to
+// alignment
+static auto mapAligned(int32_t fd, uint64_t size, uint64_t alignment)
+    -> std::expected<uint8_t*, PikaError>
+{
+    // Reserve enough address space to find an aligned start in, then give back the slack
+    auto const reservation_size = size + alignment;
+    void* reservation
+        = mmap(nullptr, reservation_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reservation == MAP_FAILED) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("mmap error: {}", error_message) });
     }
+    auto const base = static_cast<uint8_t*>(reservation);
+    auto const aligned = base
+        + (roundUp(reinterpret_cast<std::uintptr_t>(base), alignment)
+            - reinterpret_cast<std::uintptr_t>(base));
+    auto const flags = fd == -1 ? MAP_PRIVATE | MAP_ANONYMOUS : MAP_SHARED;
+    if (mmap(aligned, size, PROT_READ | PROT_WRITE, flags | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        munmap(reservation, reservation_size);
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("mmap(MAP_FIXED) error: {}", error_message) });
+    }
+    auto const mapping_end = aligned + roundUp(size, getPageSize());
+    if (aligned != base) {
+        munmap(base, static_cast<size_t>(aligned - base));
+    }
+    if (mapping_end != base + reservation_size) {
+        munmap(mapping_end, static_cast<size_t>(base + reservation_size - mapping_end));
+    }
+    return aligned;
+}
+
+auto InterProcessSharedBuffer::openSharedMemoryObject(std::string const& identifier,
+    uint64_t size) -> std::expected<int32_t, PikaError>
+{
     if (identifier.at(0) != '/') {
         return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
             .error_message = "SharedBuffer::Initialize: Shared memory "
@@ -54,7 +308,17 @@ auto InterProcessSharedBuffer::Initialize(std::string const& identifier, uint64_
         return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
             .error_message = fmt::format("shm_open error: {}", error_message) });
     }
+    auto result = sizeSharedMemoryObject(fd, identifier, size);
+    if (not result.has_value()) {
+        close(fd);
+        return std::unexpected(result.error());
+    }
+    return fd;
+}
 
+auto InterProcessSharedBuffer::sizeSharedMemoryObject(int32_t fd, std::string const& identifier,
+    uint64_t size) -> std::expected<void, PikaError>
+{
     struct stat stat { };
     auto ret_code = fstat(fd, &stat);
     if (ret_code != 0) {
@@ -82,25 +346,315 @@ auto InterProcessSharedBuffer::Initialize(std::string const& identifier, uint64_
                 .error_message = fmt::format("ftruncate failed with error:{}", error_message) });
         }
     }
+    return {};
+}
 
-    void* shared_memory_data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
-    if (*reinterpret_cast<int32_t*>(shared_memory_data) == -1) {
-        return std::unexpected(
-            PikaError { .error_message = fmt::format("mmap error: {}", strerror(errno)) });
+auto InterProcessSharedBuffer::initializeHugeTlbfs(std::string const& identifier, uint64_t size)
+    -> std::expected<void, PikaError>
+{
+    if (identifier.at(0) != '/') {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = "SharedBuffer::Initialize: Shared memory "
+                             "object must begin with a \"/\"" });
+    }
+    // Endpoints must agree on where the channel lives, a channel some endpoint established on
+    // regular pages stays there
+    auto const existing_fd = shm_open(identifier.c_str(), O_RDWR, 0);
+    if (existing_fd != -1) {
+        close(existing_fd);
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = "The channel was already established on regular pages" });
+    }
+    auto mount = findHugeTlbfsMount();
+    if (not mount.has_value()) {
+        return std::unexpected(mount.error());
+    }
+    struct statfs file_system { };
+    if (statfs(mount->c_str(), &file_system) != 0) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("statfs({}) error: {}", *mount, error_message) });
+    }
+    auto const huge_page_size = static_cast<uint64_t>(file_system.f_bsize);
+    auto const mapping_size = roundUp(size, huge_page_size);
+    auto path = *mount + identifier;
+
+    auto fd = open(path.c_str(), O_RDWR | O_CREAT, S_IRUSR | S_IWUSR);
+    if (fd == -1) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("open({}) error: {}", path, error_message) });
+    }
+    struct stat stat { };
+    if (fstat(fd, &stat) != 0) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        close(fd);
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("fstat error: {}", error_message) });
+    }
+    auto const created = stat.st_size == 0;
+    if (not created && stat.st_size != static_cast<decltype(stat.st_size)>(mapping_size)) {
+        close(fd);
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("{} already exists; however has size:{} whereas "
+                                         "current request is for {} number of bytes",
+                path, stat.st_size, mapping_size) });
+    }
+    if (created && ftruncate(fd, static_cast<off_t>(mapping_size)) != 0) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        close(fd);
+        unlink(path.c_str());
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("ftruncate({}) error: {}", path, error_message) });
+    }
+    // Huge pages are reserved when mapping, this fails if too few were set aside
+    void* data = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (data == MAP_FAILED) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        close(fd);
+        if (created) {
+            unlink(path.c_str());
+        }
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("mmap of {} huge page backed bytes failed with error: "
+                                         "{}, see vm.nr_hugepages",
+                mapping_size, error_message) });
     }
 
-    // Initialize all members
     m_fd = fd;
     m_identifier = identifier;
+    m_hugetlbfs_path = std::move(path);
+    m_size = size;
+    m_mapping_size = mapping_size;
+    m_data = static_cast<uint8_t*>(data);
+    m_segment_backing = pika::SegmentBacking { .huge_page_mode = pika::HugePageMode::Explicit,
+        .page_size = huge_page_size,
+        .fallback_reason {} };
+    return {};
+}
+
+auto InterProcessSharedBuffer::Initialize(std::string const& identifier, uint64_t size,
+    pika::HugePageMode huge_page_mode) -> std::expected<void, PikaError>
+{
+    if (m_data != nullptr) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = "SharedBuffer::Initialize: Already initialized" });
+    }
+    m_segment_backing = pika::SegmentBacking {
+        .huge_page_mode = pika::HugePageMode::None, .page_size = getPageSize(), .fallback_reason {}
+    };
+    if (huge_page_mode == pika::HugePageMode::Explicit) {
+        auto result = initializeHugeTlbfs(identifier, size);
+        if (result.has_value()) {
+            return {};
+        }
+        m_segment_backing.fallback_reason = std::string(result.error().error_message.View());
+    } else if (auto mount = findHugeTlbfsMount(); mount.has_value()
+               && access((*mount + identifier).c_str(), F_OK) == 0) {
+        // Some endpoint established the channel on huge pages, join it there rather than create
+        // a separate object that never connects
+        return initializeHugeTlbfs(identifier, size);
+    }
+    auto fd = openSharedMemoryObject(identifier, size);
+    if (not fd.has_value()) {
+        return std::unexpected(fd.error());
+    }
+    auto result = mapSharedMemoryObject(*fd, size, huge_page_mode);
+    if (not result.has_value()) {
+        close(*fd);
+        return std::unexpected(result.error());
+    }
+    m_identifier = identifier;
+    return {};
+}
+
+auto InterProcessSharedBuffer::InitializeAnonymous(int32_t channel_fd, uint64_t size,
+    pika::HugePageMode huge_page_mode) -> std::expected<void, PikaError>
+{
+    if (m_data != nullptr) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = "SharedBuffer::Initialize: Already initialized" });
+    }
+    // The endpoint owns a duplicate, the caller may close channel_fd
+    auto fd = fcntl(channel_fd, F_DUPFD_CLOEXEC, 0);
+    if (fd == -1) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("Invalid channel_fd {}: {}", channel_fd, error_message) });
+    }
+    // Whether the memory is backed by huge pages was decided when the memfd was created
+    struct statfs file_system { };
+    if (fstatfs(fd, &file_system) != 0) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        close(fd);
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("fstatfs error: {}", error_message) });
+    }
+    auto const is_hugetlbfs = file_system.f_type == HUGETLBFS_MAGIC;
+    auto const page_size
+        = is_hugetlbfs ? static_cast<uint64_t>(file_system.f_bsize) : getPageSize();
+    auto const mapping_size = roundUp(size, page_size);
+    auto result = sizeSharedMemoryObject(fd, "anonymous", mapping_size);
+    if (result.has_value()) {
+        m_segment_backing = pika::SegmentBacking { .huge_page_mode = pika::HugePageMode::None,
+            .page_size = getPageSize(),
+            .fallback_reason {} };
+        if (huge_page_mode == pika::HugePageMode::Explicit && not is_hugetlbfs) {
+            m_segment_backing.fallback_reason
+                = "The anonymous channel was created without huge pages";
+        }
+        result = mapSharedMemoryObject(fd, mapping_size,
+            is_hugetlbfs ? pika::HugePageMode::None : huge_page_mode);
+    }
+    if (not result.has_value()) {
+        close(fd);
+        return std::unexpected(result.error());
+    }
     m_size = size;
+    if (is_hugetlbfs) {
+        m_segment_backing = pika::SegmentBacking { .huge_page_mode = pika::HugePageMode::Explicit,
+            .page_size = page_size,
+            .fallback_reason {} };
+    }
+    return {};
+}
+
+auto InterProcessSharedBuffer::mapSharedMemoryObject(int32_t fd, uint64_t size,
+    pika::HugePageMode huge_page_mode) -> std::expected<void, PikaError>
+{
+    void* shared_memory_data = MAP_FAILED;
+    if (huge_page_mode == pika::HugePageMode::Transparent) {
+        // Only huge page aligned ranges of the mapping can be backed by huge pages
+        auto huge_page_size = getTransparentHugePageSize(true);
+        if (not huge_page_size.has_value()) {
+            m_segment_backing.fallback_reason
+                = std::string(huge_page_size.error().error_message.View());
+        } else {
+            auto data = mapAligned(fd, size, *huge_page_size);
+            if (not data.has_value()) {
+                return std::unexpected(data.error());
+            }
+            shared_memory_data = *data;
+            if (madvise(*data, size, MADV_HUGEPAGE) != 0) {
+                auto error_message = strerror(errno);
+                errno = 0;
+                m_segment_backing.fallback_reason
+                    = fmt::format("madvise(MADV_HUGEPAGE) error: {}", error_message);
+            } else {
+                m_segment_backing
+                    = pika::SegmentBacking { .huge_page_mode = pika::HugePageMode::Transparent,
+                          .page_size = *huge_page_size,
+                          .fallback_reason {} };
+            }
+        }
+    }
+    if (shared_memory_data == MAP_FAILED) {
+        shared_memory_data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    }
+    if (shared_memory_data == MAP_FAILED) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("mmap error: {}", error_message) });
+    }
+
+    // Initialize all members
+    m_fd = fd;
+    m_size = size;
+    m_mapping_size = size;
     m_data = static_cast<uint8_t*>(shared_memory_data);
     return {};
 }
 
+auto InterProcessSharedBuffer::InitializeMirrored(std::string const& identifier, uint64_t size,
+    uint64_t mirrored_region_offset) -> std::expected<void, PikaError>
+{
+    if (m_data != nullptr) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = "SharedBuffer::Initialize: Already initialized" });
+    }
+    auto const page_size = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    if (size % page_size != 0 || mirrored_region_offset % page_size != 0
+        || mirrored_region_offset >= size) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("SharedBuffer::InitializeMirrored: size({}) and "
+                                         "mirrored_region_offset({}) must be multiples of the "
+                                         "page size({})",
+                size, mirrored_region_offset, page_size) });
+    }
+    auto fd = openSharedMemoryObject(identifier, size);
+    if (not fd.has_value()) {
+        return std::unexpected(fd.error());
+    }
+
+    // Reserve the address range for both mappings, then map the object and the mirrored region
+    // over it
+    auto const mirrored_region_size = size - mirrored_region_offset;
+    auto const mapping_size = size + mirrored_region_size;
+    void* reservation = mmap(nullptr, mapping_size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (reservation == MAP_FAILED) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        close(*fd);
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("mmap error: {}", error_message) });
+    }
+    auto const base = static_cast<uint8_t*>(reservation);
+    void* primary
+        = mmap(base, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, *fd, 0);
+    void* mirror = primary == MAP_FAILED ? MAP_FAILED
+                                         : mmap(base + size, mirrored_region_size,
+                                             PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, *fd,
+                                             static_cast<off_t>(mirrored_region_offset));
+    if (mirror == MAP_FAILED) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        munmap(reservation, mapping_size);
+        close(*fd);
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = fmt::format("mmap(MAP_FIXED) error: {}", error_message) });
+    }
+
+    // Initialize all members
+    m_fd = *fd;
+    m_identifier = identifier;
+    m_size = size;
+    m_mapping_size = mapping_size;
+    m_data = base;
+    return {};
+}
+
+auto InterProcessSharedBuffer::Prefault() -> std::expected<void, PikaError>
+{
+    PIKA_ASSERT(m_data != nullptr);
+    return prefaultRange(m_data, m_mapping_size);
+}
+
+auto InterProcessSharedBuffer::LockMemory() -> std::expected<void, PikaError>
+{
+    PIKA_ASSERT(m_data != nullptr);
+    return lockRange(m_data, m_mapping_size);
+}
+
+auto InterProcessSharedBuffer::PlaceOnNumaNodes(pika::NumaPolicy policy, int32_t node)
+    -> std::expected<void, PikaError>
+{
+    PIKA_ASSERT(m_data != nullptr);
+    // The mapping spans whole pages
+    return placeRange(m_data, roundUp(m_mapping_size, getPageSize()), policy, node);
+}
+
 InterProcessSharedBuffer::~InterProcessSharedBuffer()
 {
     if (m_data != nullptr) {
-        auto result = munmap(m_data, m_size);
+        auto result = munmap(m_data, m_mapping_size);
         if (result != 0) {
             auto error_message = strerror(errno);
             errno = 0;
@@ -109,83 +663,260 @@ InterProcessSharedBuffer::~InterProcessSharedBuffer()
         m_data = nullptr;
     }
     if (m_fd != -1) {
-        auto result = shm_unlink(m_identifier.c_str());
-        if (result != 0) {
-            auto error_message = strerror(errno);
-            errno = 0;
-            fmt::println(
-                stderr, "shm_unlink({}) failed with error:{}", m_identifier, error_message);
+        // Anonymous channels have no name, their memory is released with the last descriptor
+        if (not m_identifier.empty()) {
+            auto result = m_hugetlbfs_path.empty() ? shm_unlink(m_identifier.c_str())
+                                                   : unlink(m_hugetlbfs_path.c_str());
+            if (result != 0) {
+                auto error_message = strerror(errno);
+                errno = 0;
+                fmt::println(
+                    stderr, "shm_unlink({}) failed with error:{}", m_identifier, error_message);
+            }
         }
+        close(m_fd);
         m_fd = -1;
     }
     m_size = 0;
+    m_mapping_size = 0;
     m_identifier.resize(0);
+    m_hugetlbfs_path.clear();
 }
 
 InterProcessSharedBuffer::InterProcessSharedBuffer(InterProcessSharedBuffer&& other)
 {
     m_identifier = other.m_identifier;
+    m_hugetlbfs_path = other.m_hugetlbfs_path;
+    m_segment_backing = other.m_segment_backing;
     m_fd = other.m_fd;
     m_data = other.m_data;
     m_size = other.m_size;
+    m_mapping_size = other.m_mapping_size;
     other.m_identifier.clear();
+    other.m_hugetlbfs_path.clear();
     other.m_fd = -1;
     other.m_data = nullptr;
     other.m_size = 0;
+    other.m_mapping_size = 0;
 }
 
 void InterProcessSharedBuffer::operator=(InterProcessSharedBuffer&& other)
 {
     m_identifier = other.m_identifier;
+    m_hugetlbfs_path = other.m_hugetlbfs_path;
+    m_segment_backing = other.m_segment_backing;
     m_fd = other.m_fd;
     m_data = other.m_data;
     m_size = other.m_size;
+    m_mapping_size = other.m_mapping_size;
     other.m_identifier.clear();
+    other.m_hugetlbfs_path.clear();
     other.m_fd = -1;
     other.m_data = nullptr;
     other.m_size = 0;
+    other.m_mapping_size = 0;
+}
+
+// Inter-thread segments are not zero filled, a fresh segment only has the first cache line of its
+// channel header, holding the initialization state, cleared. Segments spanning pages are page
+// aligned so that their pages are not shared with unrelated heap allocations.
+static auto allocateSegment(uint64_t size, pika::HugePageMode huge_page_mode)
+    -> std::expected<InterThreadSegment*, PikaError>
+{
+    auto segment = new InterThreadSegment { .data = nullptr,
+        .size = size,
+        .mapping_size = 0,
+        .backing = { .huge_page_mode = pika::HugePageMode::None,
+            .page_size = getPageSize(),
+            .fallback_reason {} },
+        .reference_count = 1 };
+    if (huge_page_mode == pika::HugePageMode::Explicit) {
+        auto huge_page_size = getDefaultHugePageSize();
+        if (huge_page_size.has_value()) {
+            auto const mapping_size = roundUp(size, *huge_page_size);
+            auto data = mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (data != MAP_FAILED) {
+                segment->data = static_cast<uint8_t*>(data);
+                segment->mapping_size = mapping_size;
+                segment->backing.huge_page_mode = pika::HugePageMode::Explicit;
+                segment->backing.page_size = *huge_page_size;
+            } else {
+                auto error_message = strerror(errno);
+                errno = 0;
+                segment->backing.fallback_reason = fmt::format("mmap(MAP_HUGETLB) error: {}, see "
+                                                               "/proc/sys/vm/nr_hugepages",
+                    error_message);
+            }
+        } else {
+            segment->backing.fallback_reason
+                = std::string(huge_page_size.error().error_message.View());
+        }
+    } else if (huge_page_mode == pika::HugePageMode::Transparent) {
+        auto huge_page_size = getTransparentHugePageSize(false);
+        if (huge_page_size.has_value()) {
+            auto const mapping_size = roundUp(size, *huge_page_size);
+            auto data = mapAligned(-1, mapping_size, *huge_page_size);
+            if (not data.has_value()) {
+                delete segment;
+                return std::unexpected(data.error());
+            }
+            segment->data = *data;
+            segment->mapping_size = mapping_size;
+            if (madvise(*data, mapping_size, MADV_HUGEPAGE) != 0) {
+                auto error_message = strerror(errno);
+                errno = 0;
+                segment->backing.fallback_reason
+                    = fmt::format("madvise(MADV_HUGEPAGE) error: {}", error_message);
+            } else {
+                segment->backing.huge_page_mode = pika::HugePageMode::Transparent;
+                segment->backing.page_size = *huge_page_size;
+            }
+        } else {
+            segment->backing.fallback_reason
+                = std::string(huge_page_size.error().error_message.View());
+        }
+    }
+    if (segment->data == nullptr) {
+        auto const alignment = size >= getPageSize() ? getPageSize() : CACHE_LINE_SIZE;
+        segment->data = static_cast<uint8_t*>(::operator new(
+            roundUp(size, alignment), std::align_val_t { alignment }, std::nothrow));
+        if (segment->data == nullptr) {
+            delete segment;
+            return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+                .error_message = fmt::format("Cannot allocate {} bytes", size) });
+        }
+    }
+    std::memset(segment->data, 0, std::min(size, CACHE_LINE_SIZE));
+    return segment;
 }
 
-struct __InternalBlock {
-    struct BufferPair {
-        std::vector<uint8_t> buffer;
-        uint64_t m_reference_count = 0;
+static auto freeSegment(InterThreadSegment* segment) -> void
+{
+    if (segment->mapping_size != 0) {
+        munmap(segment->data, segment->mapping_size);
+    } else {
+        // Heap memory outlives the segment, it must not stay locked
+        munlock(segment->data, segment->size);
+        auto const alignment = segment->size >= getPageSize() ? getPageSize() : CACHE_LINE_SIZE;
+        ::operator delete(segment->data, std::align_val_t { alignment });
+    }
+    delete segment;
+}
+
+// Named inter-thread segments. The registry is sharded by identifier so that endpoints of
+// unrelated channels rarely contend for the same lock.
+struct InterThreadRegistry {
+    static constexpr uint64_t SHARD_COUNT = 64;
+    struct alignas(CACHE_LINE_SIZE) Shard {
+        std::mutex mutex;
+        std::unordered_map<std::string, InterThreadSegment*> segments;
     };
-    std::mutex map_mutex;
-    std::unordered_map<std::string, BufferPair> buffer_map;
+    auto GetShard(std::string const& identifier) -> Shard&
+    {
+        return shards[std::hash<std::string> {}(identifier) % SHARD_COUNT];
+    }
+    std::array<Shard, SHARD_COUNT> shards;
 };
 
-static auto internal_map = __InternalBlock {};
+static auto inter_thread_registry = InterThreadRegistry {};
 
-auto InterThreadSharedBuffer::Initialize(std::string const& identifier, uint64_t size)
-    -> std::expected<void, PikaError>
+auto InterThreadSharedBuffer::Initialize(std::string const& identifier, uint64_t size,
+    pika::HugePageMode huge_page_mode) -> std::expected<void, PikaError>
 {
-
-    std::scoped_lock lk { internal_map.map_mutex };
-    if (internal_map.buffer_map.count(identifier) != 0) {
-        m_data = &(internal_map.buffer_map.at(identifier).buffer);
-        m_identifier = identifier;
+    if (m_segment != nullptr) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = "SharedBuffer::Initialize: Already initialized" });
+    }
+    auto& shard = inter_thread_registry.GetShard(identifier);
+    std::scoped_lock lk { shard.mutex };
+    auto it = shard.segments.find(identifier);
+    if (it != shard.segments.end()) {
+        // Only the endpoint that drops the last reference erases the segment, under this lock
+        it->second->reference_count.fetch_add(1);
+        m_segment = it->second;
     } else {
-        auto [pair, _] = internal_map.buffer_map.insert(
-            std::make_pair(identifier, std::vector<uint8_t>(static_cast<unsigned long>(size), 0)));
-        m_data = &pair->second.buffer;
-        m_identifier = pair->first;
+        auto segment = allocateSegment(size, huge_page_mode);
+        if (not segment.has_value()) {
+            return std::unexpected(segment.error());
+        }
+        shard.segments.emplace(identifier, *segment);
+        m_segment = *segment;
+    }
+    m_identifier = identifier;
+    return {};
+}
+
+auto InterThreadSharedBuffer::InitializeUnnamed(uint64_t size, pika::HugePageMode huge_page_mode)
+    -> std::expected<void, PikaError>
+{
+    if (m_segment != nullptr) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+            .error_message = "SharedBuffer::Initialize: Already initialized" });
     }
-    ++internal_map.buffer_map.at(identifier).m_reference_count;
+    auto segment = allocateSegment(size, huge_page_mode);
+    if (not segment.has_value()) {
+        return std::unexpected(segment.error());
+    }
+    m_segment = *segment;
     return {};
 }
 
+auto InterThreadSharedBuffer::Share() const -> InterThreadSharedBuffer
+{
+    PIKA_ASSERT(m_segment != nullptr);
+    // The reference held by this buffer keeps the segment registered meanwhile
+    m_segment->reference_count.fetch_add(1);
+    InterThreadSharedBuffer shared;
+    shared.m_identifier = m_identifier;
+    shared.m_segment = m_segment;
+    return shared;
+}
+
+auto InterThreadSharedBuffer::InitializeMirrored(std::string const&, uint64_t, uint64_t)
+    -> std::expected<void, PikaError>
+{
+    return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
+        .error_message = "Mirrored mappings are only supported by inter-process channels" });
+}
+
+auto InterThreadSharedBuffer::Prefault() -> std::expected<void, PikaError>
+{
+    PIKA_ASSERT(m_segment != nullptr);
+    return prefaultRange(m_segment->data, m_segment->size);
+}
+
+auto InterThreadSharedBuffer::LockMemory() -> std::expected<void, PikaError>
+{
+    PIKA_ASSERT(m_segment != nullptr);
+    return lockRange(m_segment->data, m_segment->size);
+}
+
+auto InterThreadSharedBuffer::PlaceOnNumaNodes(pika::NumaPolicy policy, int32_t node)
+    -> std::expected<void, PikaError>
+{
+    PIKA_ASSERT(m_segment != nullptr);
+    return placeRange(m_segment->data, m_segment->size, policy, node);
+}
+
 InterThreadSharedBuffer::~InterThreadSharedBuffer()
 {
-    if (m_data == nullptr) {
+    if (m_segment == nullptr) {
         return;
     }
-    std::scoped_lock lk { internal_map.map_mutex };
-    if (internal_map.buffer_map.count(m_identifier) != 0) {
-        if (internal_map.buffer_map.at(m_identifier).m_reference_count == 1) {
-            internal_map.buffer_map.erase(m_identifier);
-        } else {
-            --internal_map.buffer_map.at(m_identifier).m_reference_count;
+    if (m_identifier.empty()) {
+        if (m_segment->reference_count.fetch_sub(1) == 1) {
+            freeSegment(m_segment);
         }
+        return;
+    }
+    auto& shard = inter_thread_registry.GetShard(m_identifier);
+    {
+        std::scoped_lock lk { shard.mutex };
+        if (m_segment->reference_count.fetch_sub(1) != 1) {
+            return;
+        }
+        shard.segments.erase(m_identifier);
     }
-}
\ No newline at end of file
+    freeSegment(m_segment);
+}
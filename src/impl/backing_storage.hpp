@@ -22,11 +22,17 @@
 #ifndef PIKA_BACKING_STORAGE_HPP
 #define PIKA_BACKING_STORAGE_HPP
 
+#include "channel_interface.hpp"
 #include "error.hpp"
+#include "utils.hpp"
 
+#include <atomic>
 #include <cstdint>
 #include <expected>
-#include <vector>
+#include <string>
+
+// NUMA node of the CPU the calling thread runs on
+[[nodiscard]] auto GetCurrentNumaNode() -> int32_t;
 
 class InterProcessSharedBuffer {
 public:
@@ -35,7 +41,20 @@ public:
     InterProcessSharedBuffer(InterProcessSharedBuffer&&);
     void operator=(InterProcessSharedBuffer&&);
     ~InterProcessSharedBuffer();
-    [[nodiscard]] auto Initialize(std::string const& identifier, uint64_t size)
+    // Backs the buffer with the pages requested by huge_page_mode, falling back to regular pages
+    // when huge pages are not available. GetSegmentBacking reports the pages in effect.
+    [[nodiscard]] auto Initialize(std::string const& identifier, uint64_t size,
+        pika::HugePageMode huge_page_mode = pika::HugePageMode::None)
+        -> std::expected<void, PikaError>;
+    // Maps [mirrored_region_offset, size) a second time right after the end of the buffer, so
+    // that a run of bytes crossing the end of that region can be accessed through one pointer.
+    // mirrored_region_offset and size must be multiples of the page size.
+    [[nodiscard]] auto InitializeMirrored(std::string const& identifier, uint64_t size,
+        uint64_t mirrored_region_offset) -> std::expected<void, PikaError>;
+    // Maps the memory file of an anonymous channel(see Channel::CreateAnonymousChannel). The buffer
+    // keeps its own duplicate of channel_fd.
+    [[nodiscard]] auto InitializeAnonymous(int32_t channel_fd, uint64_t size,
+        pika::HugePageMode huge_page_mode = pika::HugePageMode::None)
         -> std::expected<void, PikaError>;
 
     [[nodiscard]] auto GetBuffer() const -> uint8_t*
@@ -50,42 +69,103 @@ public:
         return m_size;
     }
 
+    [[nodiscard]] auto GetSegmentBacking() const -> pika::SegmentBacking
+    {
+        return m_segment_backing;
+    }
+    // Faults every page of the buffer in without modifying it
+    [[nodiscard]] auto Prefault() -> std::expected<void, PikaError>;
+    [[nodiscard]] auto LockMemory() -> std::expected<void, PikaError>;
+    // Applies policy with mbind and migrates the pages already placed where possible. node is the
+    // target node of NumaPolicy::Bind and NumaPolicy::FollowConsumer.
+    [[nodiscard]] auto PlaceOnNumaNodes(pika::NumaPolicy policy, int32_t node)
+        -> std::expected<void, PikaError>;
+
 private:
+    // Opens(creating it if necessary) the shared memory object and sizes it to size bytes
+    [[nodiscard]] static auto openSharedMemoryObject(std::string const& identifier, uint64_t size)
+        -> std::expected<int32_t, PikaError>;
+    // Sizes a freshly created object to size bytes, or checks the size of an existing one
+    [[nodiscard]] static auto sizeSharedMemoryObject(int32_t fd, std::string const& identifier,
+        uint64_t size) -> std::expected<void, PikaError>;
+    // Maps size bytes of fd and takes ownership of fd on success
+    [[nodiscard]] auto mapSharedMemoryObject(int32_t fd, uint64_t size,
+        pika::HugePageMode huge_page_mode) -> std::expected<void, PikaError>;
+    // Maps a file on a hugetlbfs mount, sized up to a multiple of the huge page size
+    [[nodiscard]] auto initializeHugeTlbfs(std::string const& identifier, uint64_t size)
+        -> std::expected<void, PikaError>;
     std::string m_identifier;
+    std::string m_hugetlbfs_path; // Set when the buffer is a file on a hugetlbfs mount
+    pika::SegmentBacking m_segment_backing;
     int32_t m_fd = -1;
     uint8_t* m_data = nullptr;
     uint64_t m_size = 0;
+    uint64_t m_mapping_size = 0; // Larger than m_size when a region is mirrored
+};
+
+// Memory of an inter-thread channel, shared by all of its endpoints
+struct InterThreadSegment {
+    uint8_t* data = nullptr;
+    uint64_t size = 0;
+    uint64_t mapping_size = 0; // Non-zero when the memory was mapped rather than heap allocated
+    pika::SegmentBacking backing;
+    std::atomic_uint64_t reference_count = 0;
 };
 
 class InterThreadSharedBuffer {
 public:
-    [[nodiscard]] auto Initialize(std::string const& identifier, uint64_t size)
+    // Looks the segment up by identifier in a process wide registry, creating it if necessary
+    [[nodiscard]] auto Initialize(std::string const& identifier, uint64_t size,
+        pika::HugePageMode huge_page_mode = pika::HugePageMode::None)
         -> std::expected<void, PikaError>;
+    // Creates a segment that is not registered, further endpoints are attached with Share
+    [[nodiscard]] auto InitializeUnnamed(uint64_t size,
+        pika::HugePageMode huge_page_mode = pika::HugePageMode::None)
+        -> std::expected<void, PikaError>;
+    // Not supported, inter-thread buffers are private to the process
+    [[nodiscard]] auto InitializeMirrored(std::string const& identifier, uint64_t size,
+        uint64_t mirrored_region_offset) -> std::expected<void, PikaError>;
+    // Another reference to the same segment
+    [[nodiscard]] auto Share() const -> InterThreadSharedBuffer;
 
     [[nodiscard]] auto GetBuffer() const -> uint8_t*
     {
-        PIKA_ASSERT(m_data != nullptr);
-        return m_data->data();
+        PIKA_ASSERT(m_segment != nullptr);
+        return m_segment->data;
     }
 
     [[nodiscard]] auto GetSize() const -> uint64_t
     {
-        PIKA_ASSERT(m_data != nullptr);
-        return m_data->size();
+        PIKA_ASSERT(m_segment != nullptr);
+        return m_segment->size;
+    }
+
+    [[nodiscard]] auto GetSegmentBacking() const -> pika::SegmentBacking
+    {
+        PIKA_ASSERT(m_segment != nullptr);
+        return m_segment->backing;
     }
+    // Faults every page of the buffer in without modifying it
+    [[nodiscard]] auto Prefault() -> std::expected<void, PikaError>;
+    [[nodiscard]] auto LockMemory() -> std::expected<void, PikaError>;
+    // Applies policy with mbind and migrates the pages already placed where possible. node is the
+    // target node of NumaPolicy::Bind and NumaPolicy::FollowConsumer.
+    [[nodiscard]] auto PlaceOnNumaNodes(pika::NumaPolicy policy, int32_t node)
+        -> std::expected<void, PikaError>;
     ~InterThreadSharedBuffer();
     InterThreadSharedBuffer() = default;
     InterThreadSharedBuffer(InterThreadSharedBuffer const&) = delete;
     InterThreadSharedBuffer(InterThreadSharedBuffer&& other)
     {
-        this->m_data = other.m_data;
+        this->m_segment = other.m_segment;
         this->m_identifier = std::move(other.m_identifier);
+        other.m_segment = nullptr;
         other.m_identifier.clear();
     }
 
 private:
-    std::string m_identifier;
-    std::vector<uint8_t>* m_data = nullptr;
+    std::string m_identifier; // Empty for unnamed segments
+    InterThreadSegment* m_segment = nullptr;
 };
 
 #endif
\ No newline at end of file
@@ -22,25 +22,53 @@
 #ifndef PIKA_CHANNEL_HEADER_HPP
 #define PIKA_CHANNEL_HEADER_HPP
 #include "ring_buffer.hpp"
+#include "tsc_clock.hpp"
 #include <atomic>
+#include <cstdint>
 
+// States of ChannelHeader::initialization_state. While the header is initialized the state is
+// HEADER_INITIALIZING combined with the pid of the initializing process.
+static constexpr uint32_t HEADER_UNINITIALIZED = 0; // Fresh, zero filled memory
+static constexpr uint32_t HEADER_READY = 1;
+static constexpr uint32_t HEADER_INITIALIZING = 1U << 31;
+// How often endpoints waiting for another process to initialize a header check that it is alive
+static constexpr auto HEADER_INITIALIZATION_POLL_INTERVAL = pika::DurationUs { 10'000 };
+
+// The header is split so that the read-mostly configuration, the endpoint bookkeeping and the
+// ring buffer(which lays out its own producer/consumer owned state) never share a cache line.
+// The fields preceding ring_buffer have the same layout for every RingBuffer type so that
+// PrepareHeader can validate the parameters of an existing channel.
 template <RingBufferType RingBuffer> struct ChannelHeader {
-    std::atomic_bool registered = false;
-    std::atomic_uint64_t producer_count = 0;
-    std::atomic_uint64_t consumer_count = 0;
+    // Guards the initialization of the header, see PrepareHeader. Constructed as
+    // HEADER_INITIALIZING so that no other endpoint takes over while the header is constructed.
+    alignas(CACHE_LINE_SIZE) std::atomic_uint32_t initialization_state = HEADER_INITIALIZING;
+    // Read-mostly configuration
     bool single_producer_single_consumer_mode = false;
-    RingBuffer ring_buffer;
+    pika::QueueMode queue_mode = pika::QueueMode::LockProtected;
+    bool power_of_two_capacity_mode = false;
+    bool futex_mutex_mode = false;
+    pika::NumaPolicy numa_policy = pika::NumaPolicy::Default;
+    // Node the segment is placed on, -1 unless bound to a single node. Set by the first consumer
+    // under NumaPolicy::FollowConsumer.
+    std::atomic_int32_t numa_node = -1;
+    // Calibration of the process that created the channel, adopted by the others
+    TscCalibration tsc_calibration {};
+    // Only written when endpoints are created or destroyed
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t producer_count = 0;
+    std::atomic_uint64_t consumer_count = 0;
+    alignas(CACHE_LINE_SIZE) RingBuffer ring_buffer;
 };
 
 template <RingBufferType RingBuffer>
 [[nodiscard]] static constexpr auto GetRingBufferSlotsOffset(uint64_t element_alignment)
 {
     PIKA_ASSERT(element_alignment % 2 == 0);
-    if (element_alignment < sizeof(ChannelHeader<RingBuffer>)) {
-        return ((sizeof(ChannelHeader<RingBuffer>) / element_alignment) + 1) * element_alignment;
-    } else {
-        return element_alignment;
-    }
+    // Slots start on a fresh cache line so that the first slot does not share a line with the
+    // ring buffer indices
+    auto const slots_alignment
+        = element_alignment > CACHE_LINE_SIZE ? element_alignment : CACHE_LINE_SIZE;
+    return ((sizeof(ChannelHeader<RingBuffer>) + slots_alignment - 1) / slots_alignment)
+        * slots_alignment;
 }
 
 template <RingBufferType RingBuffer>
@@ -51,11 +79,32 @@ template <RingBufferType RingBuffer>
 }
 
 template <>
-[[nodiscard]] constexpr auto GetBufferSize<RingBufferLockFree>(
+[[nodiscard]] constexpr auto GetBufferSize<RingBufferLockFreeMPMC>(
+    uint64_t queue_size, uint64_t element_size, uint64_t element_alignment) -> uint64_t
+{
+    // Reserve one extra cell alignment to be able to align the cells within the buffer
+    return GetRingBufferSlotsOffset<RingBufferLockFreeMPMC>(element_alignment)
+        + RingBufferLockFreeMPMC::GetCellAlignment(element_alignment)
+        + (queue_size * RingBufferLockFreeMPMC::GetCellStride(element_size, element_alignment));
+}
+
+template <>
+[[nodiscard]] constexpr auto GetBufferSize<RingBufferConflating>(
+    uint64_t queue_size, uint64_t element_size, uint64_t element_alignment) -> uint64_t
+{
+    // Reserve one extra cell alignment to be able to align the cells within the buffer
+    return GetRingBufferSlotsOffset<RingBufferConflating>(element_alignment)
+        + RingBufferConflating::GetCellAlignment(element_alignment)
+        + (queue_size * RingBufferConflating::GetCellStride(element_size, element_alignment));
+}
+
+template <>
+[[nodiscard]] constexpr auto GetBufferSize<RingBufferProducerLanes>(
     uint64_t queue_size, uint64_t element_size, uint64_t element_alignment) -> uint64_t
 {
-    return GetRingBufferSlotsOffset<RingBufferLockFree>(element_alignment)
-        + ((queue_size + 1) * element_size);
+    // Every producer lane has queue_size slots
+    return GetRingBufferSlotsOffset<RingBufferProducerLanes>(element_alignment)
+        + (RingBufferProducerLanes::MAX_PRODUCERS * queue_size * element_size);
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -26,58 +26,251 @@
 #include "error.hpp"
 #include "ring_buffer.hpp"
 
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 namespace pika {
-auto Channel::__CreateConsumerImpl(ChannelParameters const& channel_params, uint64_t element_size,
-    uint64_t element_alignment) -> std::expected<std::unique_ptr<ConsumerImpl>, PikaError>
+
+template <typename ImplType, template <typename, typename> typename EndpointInternal,
+    RingBufferType InterProcessRingBuffer, RingBufferType InterThreadRingBuffer>
+static auto createEndpoint(ChannelParameters const& channel_params, uint64_t element_size,
+    uint64_t element_alignment) -> std::expected<std::unique_ptr<ImplType>, PikaError>
+{
+    if (channel_params.huge_page_mode != HugePageMode::None
+        && channel_params.mirrored_mapping_mode) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+            .error_message = "huge_page_mode cannot be combined with mirrored_mapping_mode" } };
+    }
+    if (channel_params.channel_type == ChannelType::AnonymousInterProcess) {
+        if (channel_params.mirrored_mapping_mode) {
+            return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+                .error_message = "mirrored_mapping_mode is not supported by anonymous channels" } };
+        }
+        if (channel_params.channel_fd < 0) {
+            return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+                .error_message = "Anonymous channels require a channel_fd" } };
+        }
+    }
+    switch (channel_params.channel_type) {
+    case ChannelType::InterProcess:
+    case ChannelType::AnonymousInterProcess:
+        return EndpointInternal<InterProcessSharedBuffer, InterProcessRingBuffer>::Create(
+            channel_params, element_size, element_alignment);
+    case ChannelType::InterThread:
+        return EndpointInternal<InterThreadSharedBuffer, InterThreadRingBuffer>::Create(
+            channel_params, element_size, element_alignment);
+    }
+    return std::unexpected { PikaError {
+        .error_type = PikaErrorType::ChannelError, .error_message = "Unknown channel type" } };
+}
+
+template <typename ImplType, template <typename, typename> typename EndpointInternal>
+static auto createEndpoint(ChannelParameters const& channel_params, uint64_t element_size,
+    uint64_t element_alignment) -> std::expected<std::unique_ptr<ImplType>, PikaError>
 {
+    if (channel_params.mirrored_mapping_mode) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+            .error_message = "mirrored_mapping_mode is only supported by byte stream channels" } };
+    }
+    if (channel_params.futex_mutex_mode
+        && (channel_params.single_producer_single_consumer_mode
+            || channel_params.queue_mode != QueueMode::LockProtected)) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+            .error_message = "futex_mutex_mode is only supported by the LockProtected queue "
+                             "mode" } };
+    }
     if (channel_params.single_producer_single_consumer_mode) {
-        switch (channel_params.channel_type) {
-        case ChannelType::InterProcess:
-            return ConsumerInternal<InterProcessSharedBuffer, RingBufferLockFree>::Create(
-                channel_params, element_size, element_alignment);
-        case ChannelType::InterThread:
-            return ConsumerInternal<InterThreadSharedBuffer, RingBufferLockFree>::Create(
-                channel_params, element_size, element_alignment);
+        if (channel_params.queue_mode != QueueMode::LockProtected) {
+            return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+                .error_message = "queue_mode cannot be combined with "
+                                 "single_producer_single_consumer_mode" } };
         }
+        return createEndpoint<ImplType, EndpointInternal, RingBufferLockFree, RingBufferLockFree>(
+            channel_params, element_size, element_alignment);
+    }
+    switch (channel_params.queue_mode) {
+    case QueueMode::LockProtected:
+        if (channel_params.futex_mutex_mode) {
+            return createEndpoint<ImplType, EndpointInternal, RingBufferFutexLockProtected,
+                RingBufferFutexLockProtected>(channel_params, element_size, element_alignment);
+        }
+        return createEndpoint<ImplType, EndpointInternal, RingBufferInterProcessLockProtected,
+            RingBufferInterThreadLockProtected>(channel_params, element_size, element_alignment);
+    case QueueMode::TwoLock:
+        return createEndpoint<ImplType, EndpointInternal, RingBufferInterProcessTwoLock,
+            RingBufferInterThreadTwoLock>(channel_params, element_size, element_alignment);
+    case QueueMode::LockFree:
+        return createEndpoint<ImplType, EndpointInternal, RingBufferLockFreeMPMC,
+            RingBufferLockFreeMPMC>(channel_params, element_size, element_alignment);
+    case QueueMode::Broadcast:
+        return createEndpoint<ImplType, EndpointInternal, RingBufferBroadcast,
+            RingBufferBroadcast>(channel_params, element_size, element_alignment);
+    case QueueMode::Conflating:
+        return createEndpoint<ImplType, EndpointInternal, RingBufferConflating,
+            RingBufferConflating>(channel_params, element_size, element_alignment);
+    case QueueMode::TripleBuffer: {
+        auto triple_buffer_params = channel_params;
+        triple_buffer_params.queue_size = RingBufferTripleBuffer::NUMBER_OF_BUFFERS;
+        return createEndpoint<ImplType, EndpointInternal, RingBufferTripleBuffer,
+            RingBufferTripleBuffer>(triple_buffer_params, element_size, element_alignment);
+    }
+    case QueueMode::ProducerLanes:
+        return createEndpoint<ImplType, EndpointInternal, RingBufferProducerLanes,
+            RingBufferProducerLanes>(channel_params, element_size, element_alignment);
+    }
+    return std::unexpected { PikaError {
+        .error_type = PikaErrorType::ChannelError, .error_message = "Unknown queue mode" } };
+}
+
+auto Channel::CreateAnonymousChannel(HugePageMode huge_page_mode)
+    -> std::expected<int32_t, PikaError>
+{
+    auto fd = -1;
+    if (huge_page_mode == HugePageMode::Explicit) {
+        // Fails when no huge pages are reserved, fall back to regular pages like named channels
+        fd = memfd_create("pika_channel", MFD_CLOEXEC | MFD_HUGETLB);
+    }
+    if (fd == -1) {
+        fd = memfd_create("pika_channel", MFD_CLOEXEC);
+    }
+    if (fd == -1) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+            .error_message = fmt::format("memfd_create error: {}", error_message) } };
+    }
+    errno = 0;
+    return fd;
+}
 
-    } else {
-        switch (channel_params.channel_type) {
-        case ChannelType::InterProcess:
-            return ConsumerInternal<InterProcessSharedBuffer,
-                RingBufferInterProcessLockProtected>::Create(channel_params, element_size,
-                element_alignment);
-        case ChannelType::InterThread:
-            return ConsumerInternal<InterThreadSharedBuffer,
-                RingBufferInterThreadLockProtected>::Create(channel_params, element_size,
-                element_alignment);
+auto Channel::SendChannelFd(int32_t socket_fd, int32_t channel_fd)
+    -> std::expected<void, PikaError>
+{
+    // Ancillary data is only delivered along with at least one byte of regular data
+    char payload = 0;
+    iovec io_vector { .iov_base = &payload, .iov_len = sizeof(payload) };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] {};
+    msghdr message {};
+    message.msg_iov = &io_vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    auto control_message = CMSG_FIRSTHDR(&message);
+    control_message->cmsg_level = SOL_SOCKET;
+    control_message->cmsg_type = SCM_RIGHTS;
+    control_message->cmsg_len = CMSG_LEN(sizeof(int));
+    std::memcpy(CMSG_DATA(control_message), &channel_fd, sizeof(int));
+    while (sendmsg(socket_fd, &message, MSG_NOSIGNAL) == -1) {
+        if (errno == EINTR) {
+            continue;
         }
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+            .error_message = fmt::format("sendmsg error: {}", error_message) } };
+    }
+    return {};
+}
+
+auto Channel::ReceiveChannelFd(int32_t socket_fd) -> std::expected<int32_t, PikaError>
+{
+    char payload = 0;
+    iovec io_vector { .iov_base = &payload, .iov_len = sizeof(payload) };
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int))] {};
+    msghdr message {};
+    message.msg_iov = &io_vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    auto received = recvmsg(socket_fd, &message, MSG_CMSG_CLOEXEC);
+    while (received == -1 && errno == EINTR) {
+        received = recvmsg(socket_fd, &message, MSG_CMSG_CLOEXEC);
+    }
+    if (received == -1) {
+        auto error_message = strerror(errno);
+        errno = 0;
+        return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+            .error_message = fmt::format("recvmsg error: {}", error_message) } };
+    }
+    auto control_message = CMSG_FIRSTHDR(&message);
+    if (received == 0 || control_message == nullptr || control_message->cmsg_level != SOL_SOCKET
+        || control_message->cmsg_type != SCM_RIGHTS
+        || control_message->cmsg_len != CMSG_LEN(sizeof(int))) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+            .error_message = "No channel descriptor was received" } };
     }
+    int32_t channel_fd = -1;
+    std::memcpy(&channel_fd, CMSG_DATA(control_message), sizeof(int));
+    return channel_fd;
+}
+
+auto Channel::__CreateConsumerImpl(ChannelParameters const& channel_params, uint64_t element_size,
+    uint64_t element_alignment) -> std::expected<std::unique_ptr<ConsumerImpl>, PikaError>
+{
+    return createEndpoint<ConsumerImpl, ConsumerInternal>(
+        channel_params, element_size, element_alignment);
 }
 
 auto Channel::__CreateProducerImpl(ChannelParameters const& channel_params, uint64_t element_size,
     uint64_t element_alignment) -> std::expected<std::unique_ptr<ProducerImpl>, PikaError>
 {
-    if (channel_params.single_producer_single_consumer_mode) {
-        switch (channel_params.channel_type) {
-        case ChannelType::InterProcess:
-            return ProducerInternal<InterProcessSharedBuffer, RingBufferLockFree>::Create(
-                channel_params, element_size, element_alignment);
-        case ChannelType::InterThread:
-            return ProducerInternal<InterThreadSharedBuffer, RingBufferLockFree>::Create(
-                channel_params, element_size, element_alignment);
-        }
+    return createEndpoint<ProducerImpl, ProducerInternal>(
+        channel_params, element_size, element_alignment);
+}
 
-    } else {
-        switch (channel_params.channel_type) {
-        case ChannelType::InterProcess:
-            return ProducerInternal<InterProcessSharedBuffer,
-                RingBufferInterProcessLockProtected>::Create(channel_params, element_size,
-                element_alignment);
-        case ChannelType::InterThread:
-            return ProducerInternal<InterThreadSharedBuffer,
-                RingBufferInterThreadLockProtected>::Create(channel_params, element_size,
-                element_alignment);
-        }
+auto Channel::__CreatePairImpl(ChannelParameters const& channel_params, uint64_t element_size,
+    uint64_t element_alignment) -> std::expected<std::unique_ptr<EndpointPairImpl>, PikaError>
+{
+    if (channel_params.channel_type != ChannelType::InterThread) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+            .error_message = "Channel pairs are only supported by inter-thread channels" } };
+    }
+    return createEndpoint<EndpointPairImpl, PairInternal>(
+        channel_params, element_size, element_alignment);
+}
+
+// Byte stream channels are always single producer single consumer rings of single byte slots.
+// A mirrored ring must start on a page boundary and span whole pages, which is achieved by
+// aligning the "elements" to the page size.
+static auto getByteChannelAlignment(ChannelParameters const& channel_params) -> uint64_t
+{
+    return channel_params.mirrored_mapping_mode ? static_cast<uint64_t>(sysconf(_SC_PAGESIZE))
+                                                : RingBufferBytes::RECORD_ALIGNMENT;
+}
+
+static auto getByteChannelParameters(ChannelParameters const& channel_params) -> ChannelParameters
+{
+    auto const alignment = getByteChannelAlignment(channel_params);
+    auto byte_channel_params = channel_params;
+    byte_channel_params.queue_size
+        = ((channel_params.queue_size + alignment - 1) / alignment) * alignment;
+    byte_channel_params.single_producer_single_consumer_mode = true;
+    return byte_channel_params;
+}
+
+auto Channel::__CreateByteProducerImpl(ChannelParameters const& channel_params)
+    -> std::expected<std::unique_ptr<ProducerImpl>, PikaError>
+{
+    if (channel_params.queue_mode != QueueMode::LockProtected) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+            .error_message = "queue_mode cannot be combined with byte stream channels" } };
+    }
+    return createEndpoint<ProducerImpl, ProducerInternal, RingBufferBytes, RingBufferBytes>(
+        getByteChannelParameters(channel_params), 1, getByteChannelAlignment(channel_params));
+}
+
+auto Channel::__CreateByteConsumerImpl(ChannelParameters const& channel_params)
+    -> std::expected<std::unique_ptr<ConsumerImpl>, PikaError>
+{
+    if (channel_params.queue_mode != QueueMode::LockProtected) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+            .error_message = "queue_mode cannot be combined with byte stream channels" } };
     }
+    return createEndpoint<ConsumerImpl, ConsumerInternal, RingBufferBytes, RingBufferBytes>(
+        getByteChannelParameters(channel_params), 1, getByteChannelAlignment(channel_params));
 }
 } // namespace pika
\ No newline at end of file
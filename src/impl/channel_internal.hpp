@@ -35,95 +35,227 @@
 
 #include <__expected/unexpected.h>
 #include <atomic>
+#include <bit>
 #include <concepts>
 #include <memory>
+#include <optional>
+#include <signal.h>
 #include <thread>
 #include <type_traits>
+#include <unistd.h>
 
 using namespace std::chrono_literals;
 
+[[nodiscard]] inline auto GetQueueLength(pika::ChannelParameters const& channel_params) -> uint64_t
+{
+    return channel_params.power_of_two_capacity_mode ? std::bit_ceil(channel_params.queue_size)
+                                                     : channel_params.queue_size;
+}
+
+// Constructs the header of a segment that no other endpoint has initialized
 template <typename BackingStorageType, RingBufferType RingBuffer>
-static auto PrepareHeader(pika::ChannelParameters const& channel_params, uint64_t element_size,
+static auto InitializeHeader(pika::ChannelParameters const& channel_params, uint64_t element_size,
     uint64_t element_alignment, BackingStorageType& storage) -> std::expected<void, PikaError>
 {
-    auto const semaphore_name = std::string(channel_params.channel_name)
-        + (channel_params.channel_type == pika::ChannelType::InterThread ? "_inter_thread"
-                                                                         : "_inter_process");
-    // Acquire exclusive access of the header(This will work across processes as well)
-    auto result = Semaphore::New(semaphore_name, 1);
-    if (!result.has_value()) {
+    // Constructing the header resets the initialization state other endpoints are watching
+    auto const initialization_state
+        = reinterpret_cast<ChannelHeader<RingBuffer>*>(storage.GetBuffer())
+              ->initialization_state.load(std::memory_order_relaxed);
+    auto header = new (storage.GetBuffer()) ChannelHeader<RingBuffer> {};
+    header->initialization_state.store(initialization_state, std::memory_order_relaxed);
+    header->single_producer_single_consumer_mode
+        = channel_params.single_producer_single_consumer_mode;
+    header->queue_mode = channel_params.queue_mode;
+    header->power_of_two_capacity_mode = channel_params.power_of_two_capacity_mode;
+    header->futex_mutex_mode = channel_params.futex_mutex_mode;
+    header->numa_policy = channel_params.numa_policy;
+    header->numa_node.store(
+        channel_params.numa_policy == pika::NumaPolicy::Bind ? channel_params.numa_node : -1);
+    if (channel_params.numa_policy == pika::NumaPolicy::Bind
+        || channel_params.numa_policy == pika::NumaPolicy::Interleave) {
+        // The policy is shared by all mappings of the segment
+        auto place_result
+            = storage.PlaceOnNumaNodes(channel_params.numa_policy, channel_params.numa_node);
+        if (not place_result.has_value()) {
+            return std::unexpected { place_result.error() };
+        }
+    }
+    header->tsc_calibration = TscClock::GetCalibration();
+    auto result = header->ring_buffer.Initialize(
+        storage.GetBuffer() + GetRingBufferSlotsOffset<RingBuffer>(element_alignment),
+        element_size, element_alignment, GetQueueLength(channel_params));
+    if (not result.has_value()) {
         return std::unexpected { result.error() };
     }
-    auto& sem = result.value();
-    sem.Wait();
-    Defer defer([&sem]() {
-        sem.Post();
-    }); // Release exclusive access of the header at the end of this block
-
-    // We now have exclusive access to either create or re-open an already
-    // existing shared memory segment
+    if constexpr (requires { header->ring_buffer.GetWaitStrategy(); }) {
+        header->ring_buffer.SetWaitStrategy(channel_params.wait_strategy);
+    }
+    header->ring_buffer.SetMirroredMapping(channel_params.mirrored_mapping_mode);
+    return {};
+}
 
+// Checks the header initialized by another endpoint against channel_params
+template <typename BackingStorageType, RingBufferType RingBuffer>
+static auto ValidateHeader(pika::ChannelParameters const& channel_params, uint64_t element_size,
+    uint64_t element_alignment, BackingStorageType& storage) -> std::expected<void, PikaError>
+{
     auto header = reinterpret_cast<ChannelHeader<RingBuffer>*>(storage.GetBuffer());
-    if (not header->registered.load()) {
-        // This segment was not previously initialized by another producer/consumer
-        header = new (header) ChannelHeader<RingBuffer> {};
-        header->single_producer_single_consumer_mode
-            = channel_params.single_producer_single_consumer_mode;
-        auto result = header->ring_buffer.Initialize(
-            storage.GetBuffer() + GetRingBufferSlotsOffset<RingBuffer>(element_alignment),
-            element_size, element_alignment, channel_params.queue_size);
-        if (not result.has_value()) {
-            return std::unexpected { result.error() };
-        }
-        header->registered.store(true);
-    } else {
-        // This segment was previously initialized by another producer / consumer
-        // Validate the header with the current parameters
-        if (channel_params.queue_size != header->ring_buffer.GetQueueLength()) {
+    TscClock::AdoptCalibration(header->tsc_calibration);
+    // Validate the header with the current parameters
+    if (channel_params.power_of_two_capacity_mode != header->power_of_two_capacity_mode) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format(
+                "Provided channel parameters has power_of_two_capacity_mode set to {}. "
+                "However channel was already established with power_of_two_capacity_mode "
+                "set to {}",
+                channel_params.power_of_two_capacity_mode,
+                header->power_of_two_capacity_mode) } };
+    }
+    if (GetQueueLength(channel_params) != header->ring_buffer.GetQueueLength()) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format("Existing ring buffer queue length: {}; Requested "
+                                         "ring buffer queue length: {}",
+                header->ring_buffer.GetQueueLength(), GetQueueLength(channel_params)) } };
+    }
+    if (element_size != header->ring_buffer.GetElementSizeInBytes()) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message
+            = fmt::format("Existing ring buffer element size(in bytes): {}; Requested "
+                          "element size(in bytes): {}",
+                header->ring_buffer.GetElementSizeInBytes(), element_size) } };
+    }
+    if (element_alignment != header->ring_buffer.GetElementAlignment()) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message
+            = fmt::format("Existing ring buffer element alignment: {}; Requested "
+                          "element alignment: {}",
+                header->ring_buffer.GetElementAlignment(), element_alignment) } };
+    }
+    if (channel_params.single_producer_single_consumer_mode
+        != header->single_producer_single_consumer_mode) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format(
+                "Provided channel parameters has "
+                "single_producer_single_consumer_mode set to {}. However channel was "
+                "already established with single_producer_single_consumer_mode set to {}",
+                channel_params.single_producer_single_consumer_mode,
+                header->single_producer_single_consumer_mode) } };
+    }
+    if (channel_params.queue_mode != header->queue_mode) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format("Provided channel parameters has queue_mode set to "
+                                         "{}. However channel was already established with "
+                                         "queue_mode set to {}",
+                static_cast<int>(channel_params.queue_mode),
+                static_cast<int>(header->queue_mode)) } };
+    }
+    if (channel_params.futex_mutex_mode != header->futex_mutex_mode) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format(
+                "Provided channel parameters has futex_mutex_mode set to {}. However "
+                "channel was already established with futex_mutex_mode set to {}",
+                channel_params.futex_mutex_mode, header->futex_mutex_mode) } };
+    }
+    if (channel_params.numa_policy != header->numa_policy
+        || (channel_params.numa_policy == pika::NumaPolicy::Bind
+            && channel_params.numa_node != header->numa_node.load())) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format("Provided channel parameters has numa_policy set to "
+                                         "{} and numa_node set to {}. However channel was "
+                                         "already established with numa_policy set to {} "
+                                         "on numa_node {}",
+                static_cast<int>(channel_params.numa_policy), channel_params.numa_node,
+                static_cast<int>(header->numa_policy), header->numa_node.load()) } };
+    }
+    if (channel_params.mirrored_mapping_mode != header->ring_buffer.IsMirroredMapping()) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format(
+                "Provided channel parameters has mirrored_mapping_mode set to {}. However "
+                "channel was already established with mirrored_mapping_mode set to {}",
+                channel_params.mirrored_mapping_mode,
+                header->ring_buffer.IsMirroredMapping()) } };
+    }
+    if constexpr (requires { header->ring_buffer.GetWaitStrategy(); }) {
+        auto const& wait_strategy = header->ring_buffer.GetWaitStrategy();
+        if (channel_params.wait_strategy != wait_strategy) {
             return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
-                .error_message = fmt::format("Existing ring buffer queue length: {}; Requested "
-                                             "ring buffer queue length: {}",
-                    header->ring_buffer.GetQueueLength(), channel_params.queue_size) } };
+                .error_message = fmt::format(
+                    "Provided channel parameters has wait_strategy set to {{type: {}, "
+                    "spin_budget: {}, max_park_duration: {}}}. However channel was already "
+                    "established with wait_strategy set to {{type: {}, spin_budget: {}, "
+                    "max_park_duration: {}}}",
+                    static_cast<int>(channel_params.wait_strategy.type),
+                    channel_params.wait_strategy.spin_budget,
+                    channel_params.wait_strategy.max_park_duration,
+                    static_cast<int>(wait_strategy.type), wait_strategy.spin_budget,
+                    wait_strategy.max_park_duration) } };
         }
-        if (element_size != header->ring_buffer.GetElementSizeInBytes()) {
-            return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
-                .error_message
-                = fmt::format("Existing ring buffer element size(in bytes): {}; Requested "
-                              "element size(in bytes): {}",
-                    header->ring_buffer.GetElementSizeInBytes(), element_size) } };
+    }
+    return {};
+}
+
+// A header left in HEADER_INITIALIZING by a process that no longer exists. pid 0 marks the short
+// window in which the header is being constructed, its initializer is alive.
+[[nodiscard]] inline auto IsHeaderInitializationAbandoned(uint32_t state) -> bool
+{
+    auto const pid = static_cast<pid_t>(state & ~HEADER_INITIALIZING);
+    if (pid == 0 || kill(pid, 0) == 0 || errno != ESRCH) {
+        errno = 0;
+        return false;
+    }
+    errno = 0;
+    return true;
+}
+
+// The header is guarded by its initialization state, which lives in the mapped segment itself
+// and starts out as HEADER_UNINITIALIZED in fresh memory. The first endpoint moves it to
+// HEADER_INITIALIZING(tagged with its pid), initializes the header and publishes it as
+// HEADER_READY; the others park on the state word until then. If the initializing process dies
+// half way, a waiter resets the state and the header is initialized again.
+template <typename BackingStorageType, RingBufferType RingBuffer>
+static auto PrepareHeader(pika::ChannelParameters const& channel_params, uint64_t element_size,
+    uint64_t element_alignment, BackingStorageType& storage) -> std::expected<void, PikaError>
+{
+    auto& state
+        = reinterpret_cast<ChannelHeader<RingBuffer>*>(storage.GetBuffer())->initialization_state;
+    static_assert(sizeof(state) == sizeof(uint32_t));
+    auto const state_word = reinterpret_cast<uint32_t const*>(&state);
+    auto const initializing_state = HEADER_INITIALIZING | static_cast<uint32_t>(getpid());
+    while (true) {
+        auto current_state = state.load(std::memory_order_acquire);
+        if (current_state == HEADER_READY) {
+            return ValidateHeader<BackingStorageType, RingBuffer>(
+                channel_params, element_size, element_alignment, storage);
         }
-        if (element_alignment != header->ring_buffer.GetElementAlignment()) {
-            return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
-                .error_message
-                = fmt::format("Existing ring buffer element alignment: {}; Requested "
-                              "element alignment: {}",
-                    header->ring_buffer.GetElementAlignment(), element_alignment) } };
+        if (current_state == HEADER_UNINITIALIZED) {
+            // The first calibration in a process takes a while, take it before the other
+            // endpoints have to wait for the header
+            static_cast<void>(TscClock::GetCalibration());
+            if (state.compare_exchange_strong(current_state, initializing_state,
+                    std::memory_order_acquire, std::memory_order_relaxed)) {
+                auto result = InitializeHeader<BackingStorageType, RingBuffer>(
+                    channel_params, element_size, element_alignment, storage);
+                // A failed initialization leaves the header to the next endpoint
+                state.store(result.has_value() ? HEADER_READY : HEADER_UNINITIALIZED,
+                    std::memory_order_release);
+                Futex::Wake(state_word, INT32_MAX);
+                return result;
+            }
+            continue;
         }
-        if (channel_params.single_producer_single_consumer_mode
-            != header->single_producer_single_consumer_mode) {
-            return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
-                .error_message = fmt::format(
-                    "Provided channel parameters has "
-                    "single_producer_single_consumer_mode set to {}. However channel was "
-                    "already established with single_producer_single_consumer_mode set to {}",
-                    channel_params.single_producer_single_consumer_mode,
-                    header->single_producer_single_consumer_mode) } };
+        if (not Futex::Wait(state_word, current_state, HEADER_INITIALIZATION_POLL_INTERVAL)
+            && IsHeaderInitializationAbandoned(current_state)) {
+            state.compare_exchange_strong(current_state, HEADER_UNINITIALIZED);
         }
     }
-    return {};
 }
 
+// Prepares the header of an initialized backing storage and applies the residency parameters
 template <typename BackingStorageType, RingBufferType RingBuffer>
-[[nodiscard]] static auto CreateBackingStorage(pika::ChannelParameters const& channel_params,
-    uint64_t element_size, uint64_t element_alignment)
+[[nodiscard]] static auto SetUpBackingStorage(pika::ChannelParameters const& channel_params,
+    uint64_t element_size, uint64_t element_alignment, BackingStorageType&& backing_storage)
     -> std::expected<BackingStorageType, PikaError>
 {
-    BackingStorageType backing_storage;
-    auto shared_buffer_result = backing_storage.Initialize(channel_params.channel_name,
-        GetBufferSize<RingBuffer>(channel_params.queue_size, element_size, element_alignment));
-    if (!shared_buffer_result.has_value()) {
-        return std::unexpected { shared_buffer_result.error() };
-    }
     if (reinterpret_cast<std::uintptr_t>(backing_storage.GetBuffer())
             % alignof(ChannelHeader<RingBuffer>)
         != 0) {
@@ -135,8 +267,58 @@ template <typename BackingStorageType, RingBufferType RingBuffer>
     if (!result.has_value()) {
         return std::unexpected { result.error() };
     }
+    // After the header is prepared, so that the pages are faulted in on the nodes the channel
+    // was placed on
+    if (channel_params.lock_memory_mode) {
+        auto lock_result = backing_storage.LockMemory();
+        if (not lock_result.has_value()) {
+            return std::unexpected { lock_result.error() };
+        }
+    }
+    if (channel_params.prefault_mode) {
+        auto prefault_result = backing_storage.Prefault();
+        if (not prefault_result.has_value()) {
+            return std::unexpected { prefault_result.error() };
+        }
+    }
     return backing_storage;
 }
+
+template <typename BackingStorageType, RingBufferType RingBuffer>
+[[nodiscard]] static auto CreateBackingStorage(pika::ChannelParameters const& channel_params,
+    uint64_t element_size, uint64_t element_alignment)
+    -> std::expected<BackingStorageType, PikaError>
+{
+    BackingStorageType backing_storage;
+    auto const buffer_size = GetBufferSize<RingBuffer>(
+        GetQueueLength(channel_params), element_size, element_alignment);
+    auto const initialize_storage = [&]() -> std::expected<void, PikaError> {
+        if constexpr (requires { backing_storage.InitializeAnonymous(0, 0); }) {
+            if (channel_params.channel_type == pika::ChannelType::AnonymousInterProcess) {
+                return backing_storage.InitializeAnonymous(
+                    channel_params.channel_fd, buffer_size, channel_params.huge_page_mode);
+            }
+        }
+        return channel_params.mirrored_mapping_mode
+            ? backing_storage.InitializeMirrored(channel_params.channel_name, buffer_size,
+                  GetRingBufferSlotsOffset<RingBuffer>(element_alignment))
+            : backing_storage.Initialize(
+                  channel_params.channel_name, buffer_size, channel_params.huge_page_mode);
+    };
+    auto shared_buffer_result = initialize_storage();
+    if (!shared_buffer_result.has_value()) {
+        return std::unexpected { shared_buffer_result.error() };
+    }
+    return SetUpBackingStorage<BackingStorageType, RingBuffer>(
+        channel_params, element_size, element_alignment, std::move(backing_storage));
+}
+
+[[nodiscard]] inline auto GetByteStreamRequiredError() -> PikaError
+{
+    return PikaError { .error_type = PikaErrorType::ChannelError,
+        .error_message = "Byte operations are only supported on byte stream channels" };
+}
+
 template <typename BackingStorageType, RingBufferType RingBuffer>
 auto GetHeader(BackingStorageType& storage) -> ChannelHeader<RingBuffer>&
 {
@@ -156,16 +338,49 @@ struct ConsumerInternal : public pika::ConsumerImpl {
         if (!backing_storage_result.has_value()) {
             return std::unexpected { backing_storage_result.error() };
         }
-        auto& header = GetHeader<BackingStorageType, RingBuffer>(*backing_storage_result);
+        return CreateOnStorage(std::move(*backing_storage_result));
+    }
+
+    // Registers the consumer on a backing storage whose header is prepared
+    static auto CreateOnStorage(BackingStorageType&& backing_storage)
+        -> std::expected<std::unique_ptr<ConsumerInternal<BackingStorageType, RingBuffer>>,
+            PikaError>
+    {
+        auto& header = GetHeader<BackingStorageType, RingBuffer>(backing_storage);
         if (header.single_producer_single_consumer_mode && header.consumer_count.load() == 1) {
             return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
                 .error_message = "Cannot register more than 1 consumer in "
                                  "single_producer_single_consumer_mode" } };
         }
+        if ((header.queue_mode == pika::QueueMode::TripleBuffer
+                || header.queue_mode == pika::QueueMode::ProducerLanes)
+            && header.consumer_count.load() == 1) {
+            return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+                .error_message = "Cannot register more than 1 consumer on a triple buffer or "
+                                 "producer lanes channel" } };
+        }
+        if (header.numa_policy == pika::NumaPolicy::FollowConsumer
+            && header.consumer_count.load() == 0) {
+            auto const node = GetCurrentNumaNode();
+            auto place_result
+                = backing_storage.PlaceOnNumaNodes(header.numa_policy, node);
+            if (not place_result.has_value()) {
+                return std::unexpected { place_result.error() };
+            }
+            header.numa_node.store(node);
+        }
+        uint64_t cursor_id = 0;
+        if constexpr (std::same_as<RingBuffer, RingBufferBroadcast>) {
+            auto register_result = header.ring_buffer.RegisterConsumer();
+            if (not register_result.has_value()) {
+                return std::unexpected { register_result.error() };
+            }
+            cursor_id = *register_result;
+        }
         header.consumer_count.fetch_add(1);
         return std::unique_ptr<ConsumerInternal<BackingStorageType, RingBuffer>>(
             new ConsumerInternal<BackingStorageType, RingBuffer>(
-                std::move(*backing_storage_result)));
+                std::move(backing_storage), cursor_id));
     }
 
     auto Connect() -> std::expected<void, PikaError> override
@@ -179,8 +394,20 @@ struct ConsumerInternal : public pika::ConsumerImpl {
     auto Receive(uint8_t* const destination_buffer, DurationUs timeout)
         -> std::expected<void, PikaError> override
     {
-        auto result = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer.PopBack(
-            destination_buffer, timeout);
+        auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+        std::expected<void, PikaError> result;
+        if constexpr (std::same_as<RingBuffer, RingBufferBroadcast>) {
+            result = ring_buffer.PopBack(m_cursor_id, destination_buffer, timeout);
+        } else if constexpr (std::same_as<RingBuffer, RingBufferConflating>) {
+            auto sequence_number
+                = ring_buffer.ReadLatest(destination_buffer, m_sequence_number, timeout);
+            if (not sequence_number.has_value()) {
+                return std::unexpected { sequence_number.error() };
+            }
+            m_sequence_number = *sequence_number;
+        } else {
+            result = ring_buffer.PopBack(destination_buffer, timeout);
+        }
         if (not result.has_value()) {
             return std::unexpected { result.error() };
         }
@@ -191,31 +418,129 @@ struct ConsumerInternal : public pika::ConsumerImpl {
     {
         return GetHeader<BackingStorageType, RingBuffer>(m_storage).producer_count.load() > 0;
     }
+    auto GetWakeupStatistics() -> pika::WakeupStatistics override
+    {
+        auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+        if constexpr (requires { ring_buffer.GetWakeupStatistics(); }) {
+            return ring_buffer.GetWakeupStatistics();
+        } else {
+            return {};
+        }
+    }
+    auto GetSegmentBacking() -> pika::SegmentBacking override
+    {
+        auto segment_backing = m_storage.GetSegmentBacking();
+        segment_backing.numa_node
+            = GetHeader<BackingStorageType, RingBuffer>(m_storage).numa_node.load();
+        return segment_backing;
+    }
     auto GetReceiveSlot(DurationUs timeout_duration)
         -> std::expected<uint8_t const* const, PikaError> override
     {
         auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
-        return ring_buffer.GetBackElementPtr(timeout_duration);
+        if constexpr (std::same_as<RingBuffer, RingBufferBroadcast>) {
+            return ring_buffer.GetBackElementPtr(m_cursor_id, timeout_duration);
+        } else {
+            return ring_buffer.GetBackElementPtr(timeout_duration);
+        }
     }
 
     auto ReleaseReceiveSlot(uint8_t const* const slot) -> std::expected<void, PikaError> override
     {
         auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
-        return ring_buffer.ReleaseBackElementPtr(slot);
+        if constexpr (std::same_as<RingBuffer, RingBufferBroadcast>) {
+            return ring_buffer.ReleaseBackElementPtr(m_cursor_id, slot);
+        } else {
+            return ring_buffer.ReleaseBackElementPtr(slot);
+        }
+    }
+
+    auto ReceiveBatch(uint8_t* const destination_buffer, uint64_t max_count, uint64_t min_count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override
+    {
+        auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+        if (min_count > max_count || min_count > ring_buffer.GetQueueLength()) {
+            return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+                .error_message = fmt::format("ReceiveBatch min_count({}) must not exceed the "
+                                             "batch size({}) or the queue length({})",
+                    min_count, max_count, ring_buffer.GetQueueLength()) } };
+        }
+        if constexpr (std::same_as<RingBuffer, RingBufferBroadcast>) {
+            return ring_buffer.PopBackBatch(
+                m_cursor_id, destination_buffer, max_count, min_count, timeout_duration);
+        } else if constexpr (std::same_as<RingBuffer, RingBufferConflating>) {
+            // Only the latest value is ever available
+            if (max_count == 0) {
+                return 0;
+            }
+            if (min_count > 1) {
+                return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+                    .error_message = "ReceiveBatch min_count must not exceed 1 on a conflating "
+                                     "channel" } };
+            }
+            auto result = Receive(destination_buffer, timeout_duration);
+            if (not result.has_value()) {
+                return std::unexpected { result.error() };
+            }
+            return 1;
+        } else {
+            return ring_buffer.PopBackBatch(
+                destination_buffer, max_count, min_count, timeout_duration);
+        }
+    }
+
+    auto ReceiveBytes(uint8_t* const destination_buffer, uint64_t destination_size,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override
+    {
+        if constexpr (std::same_as<RingBuffer, RingBufferBytes>) {
+            auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+            return ring_buffer.PopBytes(destination_buffer, destination_size, timeout_duration);
+        } else {
+            return std::unexpected { GetByteStreamRequiredError() };
+        }
+    }
+
+    auto GetSequenceNumber() -> uint64_t override { return m_sequence_number; }
+
+    auto GetReceiveBytes(DurationUs timeout_duration)
+        -> std::expected<std::span<uint8_t const>, PikaError> override
+    {
+        if constexpr (std::same_as<RingBuffer, RingBufferBytes>) {
+            auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+            return ring_buffer.PeekBytes(timeout_duration);
+        } else {
+            return std::unexpected { GetByteStreamRequiredError() };
+        }
+    }
+
+    auto ReleaseReceiveBytes(uint8_t const* const record) -> std::expected<void, PikaError> override
+    {
+        if constexpr (std::same_as<RingBuffer, RingBufferBytes>) {
+            auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+            return ring_buffer.ReleaseBytes(record);
+        } else {
+            return std::unexpected { GetByteStreamRequiredError() };
+        }
     }
 
     virtual ~ConsumerInternal()
     {
         auto& header = GetHeader<BackingStorageType, RingBuffer>(m_storage);
+        if constexpr (std::same_as<RingBuffer, RingBufferBroadcast>) {
+            header.ring_buffer.UnregisterConsumer(m_cursor_id);
+        }
         header.consumer_count.fetch_sub(1);
     }
 
 private:
-    ConsumerInternal(BackingStorageType storage)
+    ConsumerInternal(BackingStorageType storage, uint64_t cursor_id)
         : m_storage(std::move(storage))
+        , m_cursor_id(cursor_id)
     {
     }
     BackingStorageType m_storage;
+    uint64_t m_cursor_id = 0; // Read cursor of this consumer in broadcast mode
+    uint64_t m_sequence_number = 0; // Last value received in conflating mode
 };
 
 template <typename BackingStorageType, RingBufferType RingBuffer>
@@ -230,16 +555,40 @@ struct ProducerInternal : public pika::ProducerImpl {
         if (!backing_storage_result.has_value()) {
             return std::unexpected { backing_storage_result.error() };
         }
-        auto& header = GetHeader<BackingStorageType, RingBuffer>(*backing_storage_result);
+        return CreateOnStorage(std::move(*backing_storage_result));
+    }
+
+    // Registers the producer on a backing storage whose header is prepared
+    static auto CreateOnStorage(BackingStorageType&& backing_storage)
+        -> std::expected<std::unique_ptr<ProducerInternal<BackingStorageType, RingBuffer>>,
+            PikaError>
+    {
+        auto& header = GetHeader<BackingStorageType, RingBuffer>(backing_storage);
         if (header.single_producer_single_consumer_mode && header.producer_count.load() == 1) {
             return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
                 .error_message = "Cannot register more than 1 producer in "
                                  "single_producer_single_consumer_mode" } };
         }
+        if ((header.queue_mode == pika::QueueMode::Broadcast
+                || header.queue_mode == pika::QueueMode::Conflating
+                || header.queue_mode == pika::QueueMode::TripleBuffer)
+            && header.producer_count.load() == 1) {
+            return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+                .error_message = "Cannot register more than 1 producer on a broadcast, "
+                                 "conflating or triple buffer channel" } };
+        }
+        uint64_t lane_id = 0;
+        if constexpr (std::same_as<RingBuffer, RingBufferProducerLanes>) {
+            auto register_result = header.ring_buffer.RegisterProducer();
+            if (not register_result.has_value()) {
+                return std::unexpected { register_result.error() };
+            }
+            lane_id = *register_result;
+        }
         header.producer_count.fetch_add(1);
         return std::unique_ptr<ProducerInternal<BackingStorageType, RingBuffer>>(
             new ProducerInternal<BackingStorageType, RingBuffer>(
-                std::move(*backing_storage_result)));
+                std::move(backing_storage), lane_id));
     }
 
     auto Connect() -> std::expected<void, PikaError> override
@@ -254,8 +603,13 @@ struct ProducerInternal : public pika::ProducerImpl {
     auto Send(uint8_t const* const source_buffer, DurationUs timeout)
         -> std::expected<void, PikaError> override
     {
-        auto result = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer.PushFront(
-            source_buffer, timeout);
+        auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+        std::expected<void, PikaError> result;
+        if constexpr (std::same_as<RingBuffer, RingBufferProducerLanes>) {
+            result = ring_buffer.PushFront(m_lane_id, source_buffer, timeout);
+        } else {
+            result = ring_buffer.PushFront(source_buffer, timeout);
+        }
         if (not result.has_value()) {
             return std::unexpected { result.error() };
         }
@@ -267,32 +621,170 @@ struct ProducerInternal : public pika::ProducerImpl {
         -> std::expected<uint8_t* const, PikaError> override
     {
         auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
-        return ring_buffer.GetFrontElementPtr(timeout_duration);
+        if constexpr (std::same_as<RingBuffer, RingBufferProducerLanes>) {
+            return ring_buffer.GetFrontElementPtr(m_lane_id, timeout_duration);
+        } else {
+            return ring_buffer.GetFrontElementPtr(timeout_duration);
+        }
     };
 
     auto ReleaseSendSlot(uint8_t* slot) -> std::expected<void, PikaError> override
     {
         auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
-        return ring_buffer.ReleaseFrontElementPtr(slot);
+        if constexpr (std::same_as<RingBuffer, RingBufferProducerLanes>) {
+            return ring_buffer.ReleaseFrontElementPtr(m_lane_id, slot);
+        } else {
+            return ring_buffer.ReleaseFrontElementPtr(slot);
+        }
+    }
+
+    auto SendBatch(uint8_t const* const source_buffer, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override
+    {
+        auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+        auto const element_size = ring_buffer.GetElementSizeInBytes();
+        std::optional<Timer> timer;
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            timer.emplace();
+        }
+        uint64_t sent_count = 0;
+        while (sent_count < count) {
+            auto remaining_timeout = timeout_duration;
+            if (timer.has_value()) {
+                auto const elapsed = timer->GetElapsedDuration(timeout_duration);
+                remaining_timeout = elapsed < timeout_duration ? timeout_duration - elapsed : 0;
+            }
+            // Every call publishes as many elements as currently fit in the ring
+            std::expected<uint64_t, PikaError> result;
+            if constexpr (std::same_as<RingBuffer, RingBufferProducerLanes>) {
+                result = ring_buffer.PushFrontBatch(m_lane_id,
+                    source_buffer + (sent_count * element_size), count - sent_count,
+                    remaining_timeout);
+            } else {
+                result = ring_buffer.PushFrontBatch(source_buffer + (sent_count * element_size),
+                    count - sent_count, remaining_timeout);
+            }
+            if (not result.has_value()) {
+                if (result.error().error_type == PikaErrorType::Timeout && sent_count != 0) {
+                    break;
+                }
+                return std::unexpected { result.error() };
+            }
+            sent_count += *result;
+        }
+        return sent_count;
+    }
+
+    auto SendBytes(uint8_t const* const source_buffer, uint64_t size,
+        DurationUs timeout_duration) -> std::expected<void, PikaError> override
+    {
+        if constexpr (std::same_as<RingBuffer, RingBufferBytes>) {
+            auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+            return ring_buffer.PushBytes(source_buffer, size, timeout_duration);
+        } else {
+            return std::unexpected { GetByteStreamRequiredError() };
+        }
+    }
+
+    auto ReserveBytes(uint64_t size, DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError> override
+    {
+        if constexpr (std::same_as<RingBuffer, RingBufferBytes>) {
+            auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+            return ring_buffer.ReserveBytes(size, timeout_duration);
+        } else {
+            return std::unexpected { GetByteStreamRequiredError() };
+        }
+    }
+
+    auto CommitBytes(uint8_t const* const reservation) -> std::expected<void, PikaError> override
+    {
+        if constexpr (std::same_as<RingBuffer, RingBufferBytes>) {
+            auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+            return ring_buffer.CommitBytes(reservation);
+        } else {
+            return std::unexpected { GetByteStreamRequiredError() };
+        }
     }
 
     auto IsConnected() -> bool override
     {
         return GetHeader<BackingStorageType, RingBuffer>(m_storage).consumer_count.load() > 0;
     }
+    auto GetWakeupStatistics() -> pika::WakeupStatistics override
+    {
+        auto& ring_buffer = GetHeader<BackingStorageType, RingBuffer>(m_storage).ring_buffer;
+        if constexpr (requires { ring_buffer.GetWakeupStatistics(); }) {
+            return ring_buffer.GetWakeupStatistics();
+        } else {
+            return {};
+        }
+    }
+    auto GetSegmentBacking() -> pika::SegmentBacking override
+    {
+        auto segment_backing = m_storage.GetSegmentBacking();
+        segment_backing.numa_node
+            = GetHeader<BackingStorageType, RingBuffer>(m_storage).numa_node.load();
+        return segment_backing;
+    }
 
     virtual ~ProducerInternal()
     {
         auto& header = GetHeader<BackingStorageType, RingBuffer>(m_storage);
+        if constexpr (std::same_as<RingBuffer, RingBufferProducerLanes>) {
+            header.ring_buffer.UnregisterProducer(m_lane_id);
+        }
         header.producer_count.fetch_sub(1);
     }
 
 private:
-    ProducerInternal(BackingStorageType storage)
+    ProducerInternal(BackingStorageType storage, uint64_t lane_id)
         : m_storage(std::move(storage))
+        , m_lane_id(lane_id)
     {
     }
     BackingStorageType m_storage;
+    uint64_t m_lane_id = 0; // Lane of this producer in producer lanes mode
+};
+
+// Creates both endpoints of a channel on one unnamed segment
+template <typename BackingStorageType, RingBufferType RingBuffer> struct PairInternal {
+    static auto Create(pika::ChannelParameters const& channel_params, uint64_t element_size,
+        uint64_t element_alignment)
+        -> std::expected<std::unique_ptr<pika::EndpointPairImpl>, PikaError>
+    {
+        if constexpr (requires(BackingStorageType& storage) { storage.Share(); }) {
+            BackingStorageType backing_storage;
+            auto initialize_result = backing_storage.InitializeUnnamed(
+                GetBufferSize<RingBuffer>(
+                    GetQueueLength(channel_params), element_size, element_alignment),
+                channel_params.huge_page_mode);
+            if (not initialize_result.has_value()) {
+                return std::unexpected { initialize_result.error() };
+            }
+            auto backing_storage_result = SetUpBackingStorage<BackingStorageType, RingBuffer>(
+                channel_params, element_size, element_alignment, std::move(backing_storage));
+            if (not backing_storage_result.has_value()) {
+                return std::unexpected { backing_storage_result.error() };
+            }
+            // The consumer first, so that FollowConsumer places the segment on its node
+            auto consumer = ConsumerInternal<BackingStorageType, RingBuffer>::CreateOnStorage(
+                backing_storage_result->Share());
+            if (not consumer.has_value()) {
+                return std::unexpected { consumer.error() };
+            }
+            auto producer = ProducerInternal<BackingStorageType, RingBuffer>::CreateOnStorage(
+                std::move(*backing_storage_result));
+            if (not producer.has_value()) {
+                return std::unexpected { producer.error() };
+            }
+            return std::unique_ptr<pika::EndpointPairImpl>(new pika::EndpointPairImpl {
+                .producer = std::move(*producer), .consumer = std::move(*consumer) });
+        } else {
+            return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+                .error_message = "Channel pairs are only supported by inter-thread channels" } };
+        }
+    }
 };
 
-#endif
\ No newline at end of file
+#endif
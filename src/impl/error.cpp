@@ -28,6 +28,7 @@
 #endif
 #include <exception>
 #include <fmt/core.h>
+#include <ostream>
 
 void PrintAssertionMessage(
     char const* file, int line, char const* function_name, char const* message)
@@ -40,6 +41,11 @@ void PrintAssertionMessage(
     }
 }
 
+auto operator<<(std::ostream& stream, ErrorMessage const& message) -> std::ostream&
+{
+    return stream << message.View();
+}
+
 auto PrintBackTrace() -> void
 {
 #ifdef ENABLE_BACKTRACE
@@ -25,16 +25,124 @@
 #include "error.hpp"
 #include "synchronization_primitives.hpp"
 #include <__expected/unexpected.h>
+#include <algorithm>
 #include <atomic>
 #include <cstring>
 #include <expected>
+#include <new>
+#include <optional>
 #include <thread>
 
 using namespace std::chrono_literals;
 
-auto RingBufferLockProtected::initialize(RingBufferLockProtected& ring_buffer_object,
-    uint8_t* ring_buffer, uint64_t element_size, uint64_t element_alignment,
-    uint64_t number_of_elements, bool is_inter_process) -> std::expected<void, PikaError>
+// Every return from a condition variable wait consumes one pending wakeup, spurious wakeups
+// included; an underestimate only costs an unneeded signal later
+static auto ConsumeWakeup(uint64_t& wakeups_pending) -> void
+{
+    wakeups_pending -= wakeups_pending != 0 ? 1 : 0;
+}
+
+template <typename MutexType, typename ConditionVariableType>
+auto RingBufferLockProtected<MutexType, ConditionVariableType>::waitForFreeSlot(
+    Deadline const& deadline) -> std::expected<void, PikaError>
+{
+    if (m_count < m_queue_length) {
+        return {};
+    }
+    ++m_producers_waiting;
+    auto const has_free_slot = m_not_full_condition_variable.WaitUntil(
+        m_mutex, deadline, [this, woken = false]() mutable -> bool {
+            if (woken) {
+                ConsumeWakeup(m_producer_wakeups_pending);
+            }
+            woken = true;
+            return m_count < m_queue_length;
+        });
+    --m_producers_waiting;
+    if (not has_free_slot) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+            .error_message = "RingBufferLockProtected: Timed out waiting for a free slot" } };
+    }
+    return {};
+}
+
+template <typename MutexType, typename ConditionVariableType>
+auto RingBufferLockProtected<MutexType, ConditionVariableType>::waitForElements(
+    uint64_t min_count, Deadline const& deadline) -> std::expected<void, PikaError>
+{
+    if (m_count >= min_count) {
+        return {};
+    }
+    // A single signal could be consumed by a batch waiter without it being able to make
+    // progress, ask the producers to wake up all consumers instead
+    auto const is_batch_consumer = min_count > 1;
+    ++m_consumers_waiting;
+    m_batch_consumers_waiting += is_batch_consumer ? 1 : 0;
+    auto const has_elements = m_not_empty_condition_variable.WaitUntil(
+        m_mutex, deadline, [&, woken = false]() mutable -> bool {
+            if (woken) {
+                ConsumeWakeup(m_consumer_wakeups_pending);
+            }
+            woken = true;
+            return m_count >= min_count;
+        });
+    m_batch_consumers_waiting -= is_batch_consumer ? 1 : 0;
+    --m_consumers_waiting;
+    if (not has_elements) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+            .error_message = "RingBufferLockProtected: Timed out waiting for elements" } };
+    }
+    return {};
+}
+
+template <typename MutexType, typename ConditionVariableType>
+auto RingBufferLockProtected<MutexType, ConditionVariableType>::getWakeup(
+    uint64_t waiting, uint64_t& wakeups_pending, bool wake_all) -> Wakeup
+{
+    // The mutex serializes the writers, the counters need no atomic read-modify-write
+    if (waiting <= wakeups_pending) {
+        m_signals_skipped.store(
+            m_signals_skipped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return Wakeup::None;
+    }
+    m_signals_sent.store(
+        m_signals_sent.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    if (wake_all) {
+        wakeups_pending = waiting;
+        return Wakeup::All;
+    }
+    ++wakeups_pending;
+    return Wakeup::One;
+}
+
+template <typename MutexType, typename ConditionVariableType>
+auto RingBufferLockProtected<MutexType, ConditionVariableType>::notify(
+    ConditionVariableType& condition_variable, Wakeup wakeup) -> void
+{
+    switch (wakeup) {
+    case Wakeup::None:
+        break;
+    case Wakeup::One:
+        condition_variable.Signal();
+        break;
+    case Wakeup::All:
+        condition_variable.Broadcast();
+        break;
+    }
+}
+
+template <typename MutexType, typename ConditionVariableType>
+auto RingBufferLockProtected<MutexType, ConditionVariableType>::lock(Deadline const& deadline)
+    -> std::expected<void, PikaError>
+{
+    return m_mutex.LockUntil(deadline);
+}
+
+template <typename MutexType, typename ConditionVariableType>
+auto RingBufferLockProtected<MutexType, ConditionVariableType>::initialize(
+    RingBufferLockProtected& ring_buffer_object, uint8_t* ring_buffer, uint64_t element_size,
+    uint64_t element_alignment, uint64_t number_of_elements, bool is_inter_process)
+    -> std::expected<void, PikaError>
 {
     if (ring_buffer == nullptr) {
         return std::unexpected(PikaError { .error_type = PikaErrorType::RingBufferError,
@@ -46,10 +154,11 @@ auto RingBufferLockProtected::initialize(RingBufferLockProtected& ring_buffer_ob
             .error_message = "SharedRingBuffer::Initialize buffer is not aligned" });
     }
 
-    ring_buffer_object.m_ring_buffer = ring_buffer;
+    ring_buffer_object.setRingBuffer(ring_buffer);
     ring_buffer_object.m_element_alignment = element_alignment;
     ring_buffer_object.m_element_size_in_bytes = element_size;
     ring_buffer_object.m_queue_length = number_of_elements;
+    ring_buffer_object.m_index_mask = GetIndexMask(number_of_elements);
 
     auto result = ring_buffer_object.m_mutex.Initialize(is_inter_process);
     if (not result.has_value()) {
@@ -57,88 +166,100 @@ auto RingBufferLockProtected::initialize(RingBufferLockProtected& ring_buffer_ob
     }
     result = ring_buffer_object.m_not_empty_condition_variable.Initialize(is_inter_process);
     if (not result.has_value()) {
-        result.error().error_message.append("| not_empty_condition_variable");
+        result.error().error_message.Append("| not_empty_condition_variable");
         return std::unexpected(result.error());
     }
     result = ring_buffer_object.m_not_full_condition_variable.Initialize(is_inter_process);
     if (not result.has_value()) {
-        result.error().error_message.append("| not_full_condition_variable");
+        result.error().error_message.Append("| not_full_condition_variable");
         return std::unexpected(result.error());
     }
 
     return {};
 }
 
-[[nodiscard]] auto RingBufferLockProtected::PushFront(
+template <typename MutexType, typename ConditionVariableType>
+[[nodiscard]] auto RingBufferLockProtected<MutexType, ConditionVariableType>::PushFront(
     uint8_t const* const element, DurationUs timeout_duration) -> std::expected<void, PikaError>
 {
+    auto wakeup = Wakeup::None;
     {
-        auto locked_mutex_result = [&]() {
-            return timeout_duration == pika::INFINITE_TIMEOUT
-                ? LockedMutex::New(&m_mutex)
-                : LockedMutex::New(&m_mutex, timeout_duration);
-        }();
-        if (not locked_mutex_result.has_value()) {
-            return std::unexpected { locked_mutex_result.error() };
-        }
-
-        m_not_full_condition_variable.Wait(
-            locked_mutex_result.value(), [this]() -> bool { return m_count < m_queue_length; });
-        std::memcpy(getBufferSlot(m_write_index), element, m_element_size_in_bytes);
-        m_write_index = (m_write_index + 1) % m_queue_length;
+        Deadline const deadline { timeout_duration };
+        auto lock_result = lock(deadline);
+        if (not lock_result.has_value()) {
+            return std::unexpected { lock_result.error() };
+        }
+        Defer unlock([this]() {
+            static_cast<void>(m_mutex.Unlock());
+        });
+
+        auto wait_result = waitForFreeSlot(deadline);
+        if (not wait_result.has_value()) {
+            return std::unexpected { wait_result.error() };
+        }
+        std::memcpy(getBufferSlot(getSlotIndex(m_write_index)), element, m_element_size_in_bytes);
+        ++m_write_index;
         ++m_count;
+        wakeup = getWakeup(
+            m_consumers_waiting, m_consumer_wakeups_pending, m_batch_consumers_waiting != 0);
     }
-    m_not_empty_condition_variable.Signal();
+    notify(m_not_empty_condition_variable, wakeup);
     return {};
 }
 
-[[nodiscard]] auto RingBufferLockProtected::PopBack(
+template <typename MutexType, typename ConditionVariableType>
+[[nodiscard]] auto RingBufferLockProtected<MutexType, ConditionVariableType>::PopBack(
     uint8_t* const element, DurationUs timeout_duration) -> std::expected<void, PikaError>
 {
+    auto wakeup = Wakeup::None;
     {
-        auto locked_mutex_result = [&]() {
-            return timeout_duration == pika::INFINITE_TIMEOUT
-                ? LockedMutex::New(&m_mutex)
-                : LockedMutex::New(&m_mutex, timeout_duration);
-        }();
-        if (not locked_mutex_result.has_value()) {
-            return std::unexpected { locked_mutex_result.error() };
-        }
-        m_not_empty_condition_variable.Wait(
-            locked_mutex_result.value(), [&]() -> bool { return m_count != 0; });
-        std::memcpy(element, getBufferSlot(m_read_index), m_element_size_in_bytes);
-        m_read_index = (m_read_index + 1) % m_queue_length;
+        Deadline const deadline { timeout_duration };
+        auto lock_result = lock(deadline);
+        if (not lock_result.has_value()) {
+            return std::unexpected { lock_result.error() };
+        }
+        Defer unlock([this]() {
+            static_cast<void>(m_mutex.Unlock());
+        });
+
+        auto wait_result = waitForElements(1, deadline);
+        if (not wait_result.has_value()) {
+            return std::unexpected { wait_result.error() };
+        }
+        std::memcpy(element, getBufferSlot(getSlotIndex(m_read_index)), m_element_size_in_bytes);
+        ++m_read_index;
         --m_count;
+        wakeup = getWakeup(m_producers_waiting, m_producer_wakeups_pending, false);
     }
-    m_not_full_condition_variable.Signal();
+    notify(m_not_full_condition_variable, wakeup);
     return {};
 }
 
-[[nodiscard]] auto RingBufferLockProtected::GetFrontElementPtr(DurationUs timeout_duration)
-    -> std::expected<uint8_t* const, PikaError>
+template <typename MutexType, typename ConditionVariableType>
+[[nodiscard]] auto RingBufferLockProtected<MutexType, ConditionVariableType>::GetFrontElementPtr(
+    DurationUs timeout_duration) -> std::expected<uint8_t* const, PikaError>
 {
-    if (timeout_duration == INFINITE_TIMEOUT) {
-        auto lock_result = m_mutex.Lock();
-        if (not lock_result.has_value()) {
-            return std::unexpected { lock_result.error() };
-        }
-    } else {
-        auto lock_result = m_mutex.LockTimed(timeout_duration);
-        if (not lock_result.has_value()) {
-            return std::unexpected { lock_result.error() };
-        }
+    Deadline const deadline { timeout_duration };
+    auto lock_result = lock(deadline);
+    if (not lock_result.has_value()) {
+        return std::unexpected { lock_result.error() };
     }
     // Wait till we have a free slot to write to
-    m_not_full_condition_variable.Wait(
-        m_mutex, [this]() -> bool { return m_count < m_queue_length; });
+    auto wait_result = waitForFreeSlot(deadline);
+    if (not wait_result.has_value()) {
+        static_cast<void>(m_mutex.Unlock());
+        return std::unexpected { wait_result.error() };
+    }
     // We have exclusive access and have a free slot, return to caller to write into
-    return getBufferSlot(m_write_index);
+    return getBufferSlot(getSlotIndex(m_write_index));
 }
 
-[[nodiscard]] auto RingBufferLockProtected::ReleaseFrontElementPtr(uint8_t const* const element)
-    -> std::expected<void, PikaError>
+template <typename MutexType, typename ConditionVariableType>
+[[nodiscard]] auto
+RingBufferLockProtected<MutexType, ConditionVariableType>::ReleaseFrontElementPtr(
+    uint8_t const* const element) -> std::expected<void, PikaError>
 {
-    if (element != getBufferSlot(m_write_index)) {
+    if (element != getBufferSlot(getSlotIndex(m_write_index))) {
         return std::unexpected { PikaError {
             .error_type = PikaErrorType::RingBufferError,
             .error_message
@@ -147,39 +268,42 @@ auto RingBufferLockProtected::initialize(RingBufferLockProtected& ring_buffer_ob
               "the one obtained through RingBufferLockProtected::GetFrontElementPtr",
         } };
     }
-    m_write_index = (m_write_index + 1) % m_queue_length;
+    ++m_write_index;
     ++m_count;
+    auto const wakeup = getWakeup(
+        m_consumers_waiting, m_consumer_wakeups_pending, m_batch_consumers_waiting != 0);
     auto unlock_result = m_mutex.Unlock();
     if (not unlock_result.has_value()) {
         return std::unexpected { unlock_result.error() };
     }
-    m_not_empty_condition_variable.Signal();
+    notify(m_not_empty_condition_variable, wakeup);
     return {};
 }
 
-[[nodiscard]] auto RingBufferLockProtected::GetBackElementPtr(DurationUs timeout_duration)
-    -> std::expected<uint8_t const* const, PikaError>
+template <typename MutexType, typename ConditionVariableType>
+[[nodiscard]] auto RingBufferLockProtected<MutexType, ConditionVariableType>::GetBackElementPtr(
+    DurationUs timeout_duration) -> std::expected<uint8_t const* const, PikaError>
 {
-    if (timeout_duration == INFINITE_TIMEOUT) {
-        auto lock_result = m_mutex.Lock();
-        if (not lock_result.has_value()) {
-            return std::unexpected { lock_result.error() };
-        }
-    } else {
-        auto lock_result = m_mutex.LockTimed(timeout_duration);
-        if (not lock_result.has_value()) {
-            return std::unexpected { lock_result.error() };
-        }
+    Deadline const deadline { timeout_duration };
+    auto lock_result = lock(deadline);
+    if (not lock_result.has_value()) {
+        return std::unexpected { lock_result.error() };
     }
     // Wait till we have a slot to read from
-    m_not_empty_condition_variable.Wait(m_mutex, [&]() -> bool { return m_count != 0; });
-    return getBufferSlot(m_read_index);
+    auto wait_result = waitForElements(1, deadline);
+    if (not wait_result.has_value()) {
+        static_cast<void>(m_mutex.Unlock());
+        return std::unexpected { wait_result.error() };
+    }
+    return getBufferSlot(getSlotIndex(m_read_index));
 }
 
-[[nodiscard]] auto RingBufferLockProtected::ReleaseBackElementPtr(uint8_t const* const element)
-    -> std::expected<void, PikaError>
+template <typename MutexType, typename ConditionVariableType>
+[[nodiscard]] auto
+RingBufferLockProtected<MutexType, ConditionVariableType>::ReleaseBackElementPtr(
+    uint8_t const* const element) -> std::expected<void, PikaError>
 {
-    if (element != getBufferSlot(m_read_index)) {
+    if (element != getBufferSlot(getSlotIndex(m_read_index))) {
         return std::unexpected { PikaError {
             .error_type = PikaErrorType::RingBufferError,
             .error_message
@@ -188,67 +312,1965 @@ auto RingBufferLockProtected::initialize(RingBufferLockProtected& ring_buffer_ob
               "the one obtained through RingBufferLockProtected::GetBackElementPtr",
         } };
     }
-    m_read_index = (m_read_index + 1) % m_queue_length;
+    ++m_read_index;
     --m_count;
+    auto const wakeup = getWakeup(m_producers_waiting, m_producer_wakeups_pending, false);
     auto unlock_result = m_mutex.Unlock();
     if (not unlock_result.has_value()) {
         return std::unexpected { unlock_result.error() };
     }
-    m_not_full_condition_variable.Signal();
+    notify(m_not_full_condition_variable, wakeup);
+    return {};
+}
+
+template <typename MutexType, typename ConditionVariableType>
+[[nodiscard]] auto RingBufferLockProtected<MutexType, ConditionVariableType>::PushFrontBatch(
+    uint8_t const* const elements, uint64_t count, DurationUs timeout_duration)
+    -> std::expected<uint64_t, PikaError>
+{
+    if (count == 0) {
+        return 0;
+    }
+    uint64_t batch_size = 0;
+    auto wakeup = Wakeup::None;
+    {
+        Deadline const deadline { timeout_duration };
+        auto lock_result = lock(deadline);
+        if (not lock_result.has_value()) {
+            return std::unexpected { lock_result.error() };
+        }
+        Defer unlock([this]() {
+            static_cast<void>(m_mutex.Unlock());
+        });
+
+        auto wait_result = waitForFreeSlot(deadline);
+        if (not wait_result.has_value()) {
+            return std::unexpected { wait_result.error() };
+        }
+        batch_size = std::min(count, m_queue_length - m_count);
+        copyToSlots(m_write_index, elements, batch_size);
+        m_write_index += batch_size;
+        m_count += batch_size;
+        // More than one consumer may be able to make progress
+        wakeup = getWakeup(m_consumers_waiting, m_consumer_wakeups_pending,
+            m_batch_consumers_waiting != 0 || batch_size > 1);
+    }
+    // A single wakeup for the whole batch
+    notify(m_not_empty_condition_variable, wakeup);
+    return batch_size;
+}
+
+template <typename MutexType, typename ConditionVariableType>
+[[nodiscard]] auto RingBufferLockProtected<MutexType, ConditionVariableType>::PopBackBatch(
+    uint8_t* const elements, uint64_t max_count, uint64_t min_count, DurationUs timeout_duration)
+    -> std::expected<uint64_t, PikaError>
+{
+    if (max_count == 0) {
+        return 0;
+    }
+    uint64_t batch_size = 0;
+    auto wakeup = Wakeup::None;
+    {
+        Deadline const deadline { timeout_duration };
+        auto lock_result = lock(deadline);
+        if (not lock_result.has_value()) {
+            return std::unexpected { lock_result.error() };
+        }
+        Defer unlock([this]() {
+            static_cast<void>(m_mutex.Unlock());
+        });
+
+        auto wait_result = waitForElements(min_count, deadline);
+        if (not wait_result.has_value()) {
+            return std::unexpected { wait_result.error() };
+        }
+        batch_size = std::min(max_count, m_count);
+        copyFromSlots(m_read_index, elements, batch_size);
+        m_read_index += batch_size;
+        m_count -= batch_size;
+        // More than one producer may be able to make progress
+        wakeup = getWakeup(m_producers_waiting, m_producer_wakeups_pending, batch_size > 1);
+    }
+    notify(m_not_full_condition_variable, wakeup);
+    return batch_size;
+}
+
+template struct RingBufferLockProtected<Mutex, ConditionVariable>;
+template struct RingBufferLockProtected<FutexMutex, FutexConditionVariable>;
+
+auto RingBufferTwoLock::initialize(RingBufferTwoLock& ring_buffer_object, uint8_t* ring_buffer,
+    uint64_t element_size, uint64_t element_alignment, uint64_t number_of_elements,
+    bool is_inter_process) -> std::expected<void, PikaError>
+{
+    if (ring_buffer == nullptr) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "RingBufferTwoLock::Initialize buffer==nullptr" });
+    }
+    if (reinterpret_cast<std::uintptr_t>(ring_buffer) % element_alignment != 0) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "RingBufferTwoLock::Initialize buffer is not aligned" });
+    }
+
+    ring_buffer_object.setRingBuffer(ring_buffer);
+    ring_buffer_object.m_element_alignment = element_alignment;
+    ring_buffer_object.m_element_size_in_bytes = element_size;
+    ring_buffer_object.m_queue_length = number_of_elements;
+    ring_buffer_object.m_index_mask = GetIndexMask(number_of_elements);
+    ring_buffer_object.m_write_index = 0;
+    ring_buffer_object.m_read_index = 0;
+    ring_buffer_object.m_batch_consumers_waiting.store(0);
+    ring_buffer_object.m_count.store(0);
+
+    auto result = ring_buffer_object.m_producer_mutex.Initialize(is_inter_process);
+    if (not result.has_value()) {
+        result.error().error_message.Append("| producer_mutex");
+        return std::unexpected(result.error());
+    }
+    result = ring_buffer_object.m_consumer_mutex.Initialize(is_inter_process);
+    if (not result.has_value()) {
+        result.error().error_message.Append("| consumer_mutex");
+        return std::unexpected(result.error());
+    }
+    result = ring_buffer_object.m_not_empty_condition_variable.Initialize(is_inter_process);
+    if (not result.has_value()) {
+        result.error().error_message.Append("| not_empty_condition_variable");
+        return std::unexpected(result.error());
+    }
+    result = ring_buffer_object.m_not_full_condition_variable.Initialize(is_inter_process);
+    if (not result.has_value()) {
+        result.error().error_message.Append("| not_full_condition_variable");
+        return std::unexpected(result.error());
+    }
+    return {};
+}
+
+auto RingBufferTwoLock::timeoutError(Mutex& locked_mutex, ErrorMessage error_message)
+    -> PikaError
+{
+    static_cast<void>(locked_mutex.Unlock());
+    return PikaError {
+        .error_type = PikaErrorType::Timeout, .error_message = std::move(error_message)
+    };
+}
+
+auto RingBufferTwoLock::publish(uint64_t count) -> uint64_t
+{
+    m_write_index += count;
+    // Release the written slots to the consumers. Sequentially consistent so that either a
+    // consumer about to wait for a batch sees the new count or signalNotEmpty sees the consumer.
+    auto const previous_count = m_count.fetch_add(count);
+    if (previous_count + count < m_queue_length) {
+        m_not_full_condition_variable.Signal();
+    }
+    return previous_count;
+}
+
+auto RingBufferTwoLock::consume(uint64_t count) -> uint64_t
+{
+    m_read_index += count;
+    // Release the read slots to the producers
+    auto const previous_count = m_count.fetch_sub(count, std::memory_order_acq_rel);
+    if (previous_count - count != 0) {
+        // A single signal could be taken by a batch consumer that cannot make progress
+        if (m_batch_consumers_waiting.load() != 0) {
+            m_not_empty_condition_variable.Broadcast();
+        } else {
+            m_not_empty_condition_variable.Signal();
+        }
+    }
+    return previous_count;
+}
+
+auto RingBufferTwoLock::signalNotEmpty(uint64_t previous_count, uint64_t count) -> void
+{
+    // Consumers only wait on an empty queue, unless they are waiting for a batch
+    auto const batch_consumers_waiting = m_batch_consumers_waiting.load() != 0;
+    if (previous_count != 0 && not batch_consumers_waiting) {
+        return;
+    }
+    // Taking the lock orders the signal after the waiter's predicate check
+    if (not m_consumer_mutex.Lock().has_value()) {
+        return;
+    }
+    if (count > 1 || batch_consumers_waiting) {
+        m_not_empty_condition_variable.Broadcast();
+    } else {
+        m_not_empty_condition_variable.Signal();
+    }
+    static_cast<void>(m_consumer_mutex.Unlock());
+}
+
+auto RingBufferTwoLock::signalNotFull(uint64_t previous_count, uint64_t count) -> void
+{
+    if (previous_count != m_queue_length) {
+        return;
+    }
+    if (not m_producer_mutex.Lock().has_value()) {
+        return;
+    }
+    if (count > 1) {
+        m_not_full_condition_variable.Broadcast();
+    } else {
+        m_not_full_condition_variable.Signal();
+    }
+    static_cast<void>(m_producer_mutex.Unlock());
+}
+
+auto RingBufferTwoLock::PushFront(uint8_t const* const element, DurationUs timeout_duration)
+    -> std::expected<void, PikaError>
+{
+    auto slot = GetFrontElementPtr(timeout_duration);
+    if (not slot.has_value()) {
+        return std::unexpected { slot.error() };
+    }
+    std::memcpy(*slot, element, m_element_size_in_bytes);
+    return ReleaseFrontElementPtr(*slot);
+}
+
+auto RingBufferTwoLock::PopBack(uint8_t* const element, DurationUs timeout_duration)
+    -> std::expected<void, PikaError>
+{
+    auto slot = GetBackElementPtr(timeout_duration);
+    if (not slot.has_value()) {
+        return std::unexpected { slot.error() };
+    }
+    std::memcpy(element, *slot, m_element_size_in_bytes);
+    return ReleaseBackElementPtr(*slot);
+}
+
+auto RingBufferTwoLock::GetFrontElementPtr(DurationUs timeout_duration)
+    -> std::expected<uint8_t* const, PikaError>
+{
+    Deadline const deadline { timeout_duration };
+    auto lock_result = m_producer_mutex.LockUntil(deadline);
+    if (not lock_result.has_value()) {
+        return std::unexpected { lock_result.error() };
+    }
+    if (not m_not_full_condition_variable.WaitUntil(m_producer_mutex, deadline, [this]() -> bool {
+            return m_count.load(std::memory_order_acquire) < m_queue_length;
+        })) {
+        return std::unexpected { timeoutError(
+            m_producer_mutex, "RingBufferTwoLock: Timed out waiting for a free slot") };
+    }
+    // Only the producer holding the lock writes to the slot at the write index
+    return getBufferSlot(getSlotIndex(m_write_index));
+}
+
+auto RingBufferTwoLock::ReleaseFrontElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    if (element != getBufferSlot(getSlotIndex(m_write_index))) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to RingBufferTwoLock::ReleaseFrontElementPtr "
+                             "not the front pointer. Ensure that the pointer given to this "
+                             "function is the one obtained through "
+                             "RingBufferTwoLock::GetFrontElementPtr",
+        } };
+    }
+    auto const previous_count = publish(1);
+    auto unlock_result = m_producer_mutex.Unlock();
+    if (not unlock_result.has_value()) {
+        return std::unexpected { unlock_result.error() };
+    }
+    signalNotEmpty(previous_count, 1);
+    return {};
+}
+
+auto RingBufferTwoLock::GetBackElementPtr(DurationUs timeout_duration)
+    -> std::expected<uint8_t const* const, PikaError>
+{
+    Deadline const deadline { timeout_duration };
+    auto lock_result = m_consumer_mutex.LockUntil(deadline);
+    if (not lock_result.has_value()) {
+        return std::unexpected { lock_result.error() };
+    }
+    if (not m_not_empty_condition_variable.WaitUntil(m_consumer_mutex, deadline,
+            [this]() -> bool { return m_count.load(std::memory_order_acquire) != 0; })) {
+        return std::unexpected { timeoutError(
+            m_consumer_mutex, "RingBufferTwoLock: Timed out waiting for an element") };
+    }
+    return getBufferSlot(getSlotIndex(m_read_index));
+}
+
+auto RingBufferTwoLock::ReleaseBackElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    if (element != getBufferSlot(getSlotIndex(m_read_index))) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to RingBufferTwoLock::ReleaseBackElementPtr "
+                             "not the back pointer. Ensure that the pointer given to this "
+                             "function is the one obtained through "
+                             "RingBufferTwoLock::GetBackElementPtr",
+        } };
+    }
+    auto const previous_count = consume(1);
+    auto unlock_result = m_consumer_mutex.Unlock();
+    if (not unlock_result.has_value()) {
+        return std::unexpected { unlock_result.error() };
+    }
+    signalNotFull(previous_count, 1);
     return {};
 }
 
+auto RingBufferTwoLock::PushFrontBatch(uint8_t const* const elements, uint64_t count,
+    DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (count == 0) {
+        return 0;
+    }
+    auto slot = GetFrontElementPtr(timeout_duration);
+    if (not slot.has_value()) {
+        return std::unexpected { slot.error() };
+    }
+    // Consumers can only free up more slots in the meantime
+    auto const batch_size
+        = std::min(count, m_queue_length - m_count.load(std::memory_order_acquire));
+    copyToSlots(m_write_index, elements, batch_size);
+    auto const previous_count = publish(batch_size);
+    auto unlock_result = m_producer_mutex.Unlock();
+    if (not unlock_result.has_value()) {
+        return std::unexpected { unlock_result.error() };
+    }
+    signalNotEmpty(previous_count, batch_size);
+    return batch_size;
+}
+
+auto RingBufferTwoLock::PopBackBatch(uint8_t* const elements, uint64_t max_count,
+    uint64_t min_count, DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (max_count == 0) {
+        return 0;
+    }
+    Deadline const deadline { timeout_duration };
+    auto lock_result = m_consumer_mutex.LockUntil(deadline);
+    if (not lock_result.has_value()) {
+        return std::unexpected { lock_result.error() };
+    }
+    auto const wait_count = std::max<uint64_t>(min_count, 1);
+    auto const enough_elements = [&]() -> bool { return m_count.load() >= wait_count; };
+    if (not enough_elements()) {
+        // Producers only signal the empty->not empty transition, unless a consumer is waiting
+        // for more than one element
+        if (wait_count > 1) {
+            m_batch_consumers_waiting.fetch_add(1);
+        }
+        auto const has_elements = m_not_empty_condition_variable.WaitUntil(
+            m_consumer_mutex, deadline, enough_elements);
+        if (wait_count > 1) {
+            m_batch_consumers_waiting.fetch_sub(1);
+        }
+        if (not has_elements) {
+            return std::unexpected { timeoutError(
+                m_consumer_mutex, "RingBufferTwoLock: Timed out waiting for elements") };
+        }
+    }
+    // Producers can only publish more elements in the meantime
+    auto const batch_size = std::min(max_count, m_count.load(std::memory_order_acquire));
+    copyFromSlots(m_read_index, elements, batch_size);
+    auto const previous_count = consume(batch_size);
+    auto unlock_result = m_consumer_mutex.Unlock();
+    if (not unlock_result.has_value()) {
+        return std::unexpected { unlock_result.error() };
+    }
+    signalNotFull(previous_count, batch_size);
+    return batch_size;
+}
+
 auto RingBufferLockFree::Initialize(uint8_t* buffer, uint64_t element_size,
     uint64_t element_alignment, uint64_t number_of_elements) -> std::expected<void, PikaError>
 {
-    m_ring_buffer = buffer;
+    setRingBuffer(buffer);
     m_element_size_in_bytes = element_size;
     m_element_alignment = element_alignment;
     m_queue_length = number_of_elements;
-    m_internal_queue_length = m_queue_length + 1;
+    m_index_mask = GetIndexMask(number_of_elements);
     m_head.store(0);
     m_tail.store(0);
+    m_cached_head = 0;
+    m_cached_tail = 0;
+    m_parked_producers.store(0);
+    m_parked_consumers.store(0);
     return {};
 }
 
 auto RingBufferLockFree::PushFront(uint8_t const* const element, DurationUs timeout_duration)
     -> std::expected<void, PikaError>
 {
-    auto const current_tail = m_tail.load(std::memory_order_relaxed);
-    auto const next_tail = incrementByOne(current_tail);
-    if (timeout_duration == pika::INFINITE_TIMEOUT) {
-        while (next_tail == m_head.load(std::memory_order_acquire)) {
-            // Busy wait; TODO: Detemine best strategy here
-        }
-    } else {
-        Timer timer;
-        while (next_tail == m_head.load(std::memory_order_acquire)
-            && timer.GetElapsedDuration() < timeout_duration) {
-            // Busy wait; TODO: Detemine best strategy here
-        }
+    auto current_tail = waitForFreeSlot(timeout_duration);
+    if (not current_tail.has_value()) {
+        return std::unexpected { current_tail.error() };
     }
-    std::memcpy(getBufferSlot_(current_tail), element, m_element_size_in_bytes);
-    m_tail.store(next_tail, std::memory_order_release);
+    std::memcpy(getBufferSlot(getSlotIndex(*current_tail)), element, m_element_size_in_bytes);
+    m_tail.store(*current_tail + 1, std::memory_order_release);
+    Backoff::WakeParked(m_wait_strategy, m_tail, m_parked_consumers);
     return {};
 }
 
 auto RingBufferLockFree::PopBack(uint8_t* const element, DurationUs timeout_duration)
     -> std::expected<void, PikaError>
 {
-    auto const current_head = m_head.load(std::memory_order_relaxed);
-    if (timeout_duration == pika::INFINITE_TIMEOUT) {
-        while (current_head == m_tail.load(std::memory_order_acquire)) {
-            // Busy wait; TODO: Detemine best strategy here
+    auto current_head = waitForElement(timeout_duration);
+    if (not current_head.has_value()) {
+        return std::unexpected { current_head.error() };
+    }
+    std::memcpy(element, getBufferSlot(getSlotIndex(*current_head)), m_element_size_in_bytes);
+    m_head.store(*current_head + 1, std::memory_order_release);
+    Backoff::WakeParked(m_wait_strategy, m_head, m_parked_producers);
+    return {};
+}
+
+auto RingBufferLockFree::SetWaitStrategy(pika::WaitStrategy const& wait_strategy) -> void
+{
+    m_wait_strategy = wait_strategy;
+}
+
+auto RingBufferLockFree::waitForFreeSlot(DurationUs timeout_duration)
+    -> std::expected<uint64_t, PikaError>
+{
+    auto const current_tail = m_tail.load(std::memory_order_relaxed);
+    if (current_tail - m_cached_head != m_queue_length) {
+        return current_tail;
+    }
+    // Cached head says the ring is full, refresh it from the consumer's cache line
+    Timer timer;
+    Backoff backoff { m_wait_strategy, m_head, m_parked_producers };
+    while (current_tail - (m_cached_head = m_head.load(std::memory_order_acquire))
+        == m_queue_length) {
+        auto remaining_duration = pika::INFINITE_TIMEOUT;
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            auto const elapsed_duration = timer.GetElapsedDuration(timeout_duration);
+            if (elapsed_duration >= timeout_duration) {
+                return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                    .error_message = "RingBufferLockFree: Timed out waiting for a free slot" } };
+            }
+            remaining_duration = timeout_duration - elapsed_duration;
         }
+        backoff.Pause(m_cached_head, remaining_duration);
+    }
+    return current_tail;
+}
 
-    } else {
-        Timer timer;
-        while (current_head == m_tail.load(std::memory_order_acquire)
-            && timer.GetElapsedDuration() < timeout_duration) {
-            // Busy wait; TODO: Detemine best strategy here
+auto RingBufferLockFree::waitForElement(DurationUs timeout_duration, uint64_t min_count)
+    -> std::expected<uint64_t, PikaError>
+{
+    auto const current_head = m_head.load(std::memory_order_relaxed);
+    if (m_cached_tail - current_head >= min_count) {
+        return current_head;
+    }
+    // Cached tail says the ring holds too few elements, refresh it from the producer's cache line
+    Timer timer;
+    Backoff backoff { m_wait_strategy, m_tail, m_parked_consumers };
+    while ((m_cached_tail = m_tail.load(std::memory_order_acquire)) - current_head < min_count) {
+        auto remaining_duration = pika::INFINITE_TIMEOUT;
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            auto const elapsed_duration = timer.GetElapsedDuration(timeout_duration);
+            if (elapsed_duration >= timeout_duration) {
+                return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                    .error_message = "RingBufferLockFree: Timed out waiting for an element" } };
+            }
+            remaining_duration = timeout_duration - elapsed_duration;
         }
+        backoff.Pause(m_cached_tail, remaining_duration);
     }
-    std::memcpy(element, getBufferSlot_(current_head), m_element_size_in_bytes);
-    m_head.store(incrementByOne(current_head), std::memory_order_release);
+    return current_head;
+}
+
+auto RingBufferLockFree::GetFrontElementPtr(DurationUs timeout_duration)
+    -> std::expected<uint8_t* const, PikaError>
+{
+    auto current_tail = waitForFreeSlot(timeout_duration);
+    if (not current_tail.has_value()) {
+        return std::unexpected { current_tail.error() };
+    }
+    // The slot at the tail is owned by the single producer until the tail is advanced
+    return getBufferSlot(getSlotIndex(*current_tail));
+}
+
+auto RingBufferLockFree::ReleaseFrontElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    auto const current_tail = m_tail.load(std::memory_order_relaxed);
+    if (element != getBufferSlot(getSlotIndex(current_tail))) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to RingBufferLockFree::ReleaseFrontElementPtr "
+                             "not the front pointer. Ensure that the pointer given to this "
+                             "function is the one obtained through "
+                             "RingBufferLockFree::GetFrontElementPtr",
+        } };
+    }
+    // Publish the written slot to the consumer
+    m_tail.store(current_tail + 1, std::memory_order_release);
+    Backoff::WakeParked(m_wait_strategy, m_tail, m_parked_consumers);
+    return {};
+}
+
+auto RingBufferLockFree::GetBackElementPtr(DurationUs timeout_duration)
+    -> std::expected<uint8_t const* const, PikaError>
+{
+    auto current_head = waitForElement(timeout_duration);
+    if (not current_head.has_value()) {
+        return std::unexpected { current_head.error() };
+    }
+    // The slot at the head is owned by the single consumer until the head is advanced
+    return getBufferSlot(getSlotIndex(*current_head));
+}
+
+auto RingBufferLockFree::ReleaseBackElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    auto const current_head = m_head.load(std::memory_order_relaxed);
+    if (element != getBufferSlot(getSlotIndex(current_head))) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to RingBufferLockFree::ReleaseBackElementPtr "
+                             "not the back pointer. Ensure that the pointer given to this "
+                             "function is the one obtained through "
+                             "RingBufferLockFree::GetBackElementPtr",
+        } };
+    }
+    // Hand the slot back to the producer
+    m_head.store(current_head + 1, std::memory_order_release);
+    Backoff::WakeParked(m_wait_strategy, m_head, m_parked_producers);
     return {};
-}
\ No newline at end of file
+}
+
+auto RingBufferLockFree::PushFrontBatch(uint8_t const* const elements, uint64_t count,
+    DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (count == 0) {
+        return 0;
+    }
+    auto current_tail = waitForFreeSlot(timeout_duration);
+    if (not current_tail.has_value()) {
+        return std::unexpected { current_tail.error() };
+    }
+    auto const free_slots = m_queue_length - (*current_tail - m_cached_head);
+    auto const batch_size = std::min(count, free_slots);
+    copyToSlots(*current_tail, elements, batch_size);
+    m_tail.store(*current_tail + batch_size, std::memory_order_release);
+    Backoff::WakeParked(m_wait_strategy, m_tail, m_parked_consumers);
+    return batch_size;
+}
+
+auto RingBufferLockFree::PopBackBatch(uint8_t* const elements, uint64_t max_count,
+    uint64_t min_count, DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (max_count == 0) {
+        return 0;
+    }
+    auto current_head = waitForElement(timeout_duration, min_count);
+    if (not current_head.has_value()) {
+        return std::unexpected { current_head.error() };
+    }
+    auto const batch_size = std::min(max_count, m_cached_tail - *current_head);
+    copyFromSlots(*current_head, elements, batch_size);
+    m_head.store(*current_head + batch_size, std::memory_order_release);
+    Backoff::WakeParked(m_wait_strategy, m_head, m_parked_producers);
+    return batch_size;
+}
+
+auto RingBufferLockFreeMPMC::Initialize(uint8_t* buffer, uint64_t element_size,
+    uint64_t element_alignment, uint64_t number_of_elements) -> std::expected<void, PikaError>
+{
+    if (buffer == nullptr) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "RingBufferLockFreeMPMC::Initialize buffer==nullptr" });
+    }
+    if (number_of_elements == 0) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "RingBufferLockFreeMPMC::Initialize queue length must be non-zero" });
+    }
+    // The slots offset is only guaranteed to be aligned to the element alignment, the cells
+    // additionally need to be aligned for their sequence counters.
+    auto const cell_alignment = GetCellAlignment(element_alignment);
+    auto const misalignment = reinterpret_cast<std::uintptr_t>(buffer) % cell_alignment;
+    if (misalignment != 0) {
+        buffer += cell_alignment - misalignment;
+    }
+    setRingBuffer(buffer);
+    m_element_size_in_bytes = element_size;
+    m_element_alignment = element_alignment;
+    m_queue_length = number_of_elements;
+    m_index_mask = GetIndexMask(number_of_elements);
+    m_cell_stride = GetCellStride(element_size, element_alignment);
+    m_element_offset = cell_alignment;
+    for (uint64_t index = 0; index < m_queue_length; ++index) {
+        new (&getCellSequence(index)) std::atomic_uint64_t { index };
+    }
+    m_enqueue_position.store(0);
+    m_dequeue_position.store(0);
+    return {};
+}
+
+auto RingBufferLockFreeMPMC::reserveFront(DurationUs timeout_duration, uint64_t max_count)
+    -> std::expected<Reservation, PikaError>
+{
+    std::optional<Timer> timer;
+    auto position = m_enqueue_position.load(std::memory_order_relaxed);
+    while (true) {
+        auto const sequence = getCellSequence(position).load(std::memory_order_acquire);
+        auto const difference = static_cast<int64_t>(sequence - position);
+        if (difference == 0) {
+            // Cell is free for this position, extend the claim over the following free cells
+            uint64_t count = 1;
+            while (count < max_count && count < m_queue_length
+                && getCellSequence(position + count).load(std::memory_order_acquire)
+                    == position + count) {
+                ++count;
+            }
+            if (m_enqueue_position.compare_exchange_weak(
+                    position, position + count, std::memory_order_relaxed)) {
+                return Reservation { .position = position, .count = count };
+            }
+        } else if (difference < 0) {
+            // Cell still holds an element from the previous lap; the queue is full
+            if (timeout_duration != pika::INFINITE_TIMEOUT) {
+                if (not timer.has_value()) {
+                    timer.emplace();
+                } else if (timer->GetElapsedDuration(timeout_duration) >= timeout_duration) {
+                    return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                        .error_message = "RingBufferLockFreeMPMC: Timed out waiting for a free "
+                                         "slot" } };
+                }
+            }
+            std::this_thread::yield();
+            position = m_enqueue_position.load(std::memory_order_relaxed);
+        } else {
+            // Another producer claimed this position, retry with the latest one
+            position = m_enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+auto RingBufferLockFreeMPMC::reserveBack(
+    DurationUs timeout_duration, uint64_t max_count, uint64_t min_count)
+    -> std::expected<Reservation, PikaError>
+{
+    std::optional<Timer> timer;
+    auto position = m_dequeue_position.load(std::memory_order_relaxed);
+    while (true) {
+        auto const sequence = getCellSequence(position).load(std::memory_order_acquire);
+        auto const difference = static_cast<int64_t>(sequence - (position + 1));
+        uint64_t count = 0;
+        if (difference == 0) {
+            // Cell has been published for this position, extend the claim over the following
+            // published cells
+            count = 1;
+            while (count < max_count && count < m_queue_length
+                && getCellSequence(position + count).load(std::memory_order_acquire)
+                    == position + count + 1) {
+                ++count;
+            }
+            if (count >= min_count) {
+                if (m_dequeue_position.compare_exchange_weak(
+                        position, position + count, std::memory_order_relaxed)) {
+                    return Reservation { .position = position, .count = count };
+                }
+                continue;
+            }
+        }
+        if (difference <= 0) {
+            // Not enough published cells; the queue is empty or holds less than min_count
+            // elements
+            if (timeout_duration != pika::INFINITE_TIMEOUT) {
+                if (not timer.has_value()) {
+                    timer.emplace();
+                } else if (timer->GetElapsedDuration(timeout_duration) >= timeout_duration) {
+                    return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                        .error_message = "RingBufferLockFreeMPMC: Timed out waiting for an "
+                                         "element" } };
+                }
+            }
+            std::this_thread::yield();
+        }
+        // Either waited or another consumer claimed this position, retry with the latest one
+        position = m_dequeue_position.load(std::memory_order_relaxed);
+    }
+}
+
+auto RingBufferLockFreeMPMC::getCellSequenceFromElement(uint8_t const* const element)
+    -> std::expected<std::atomic_uint64_t*, PikaError>
+{
+    auto const element_offset = element - getRingBuffer() - static_cast<int64_t>(m_element_offset);
+    if (element == nullptr || element_offset < 0
+        || static_cast<uint64_t>(element_offset) % m_cell_stride != 0
+        || static_cast<uint64_t>(element_offset) / m_cell_stride >= m_queue_length) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to RingBufferLockFreeMPMC does not point to a "
+                             "slot obtained through GetFrontElementPtr/GetBackElementPtr" } };
+    }
+    return &getCellSequence(static_cast<uint64_t>(element_offset) / m_cell_stride);
+}
+
+auto RingBufferLockFreeMPMC::PushFront(uint8_t const* const element, DurationUs timeout_duration)
+    -> std::expected<void, PikaError>
+{
+    auto reservation = reserveFront(timeout_duration);
+    if (not reservation.has_value()) {
+        return std::unexpected { reservation.error() };
+    }
+    auto const position = reservation->position;
+    std::memcpy(getCellElement(position), element, m_element_size_in_bytes);
+    getCellSequence(position).store(position + 1, std::memory_order_release);
+    return {};
+}
+
+auto RingBufferLockFreeMPMC::PopBack(uint8_t* const element, DurationUs timeout_duration)
+    -> std::expected<void, PikaError>
+{
+    auto reservation = reserveBack(timeout_duration);
+    if (not reservation.has_value()) {
+        return std::unexpected { reservation.error() };
+    }
+    auto const position = reservation->position;
+    std::memcpy(element, getCellElement(position), m_element_size_in_bytes);
+    getCellSequence(position).store(position + m_queue_length, std::memory_order_release);
+    return {};
+}
+
+auto RingBufferLockFreeMPMC::GetFrontElementPtr(DurationUs timeout_duration)
+    -> std::expected<uint8_t* const, PikaError>
+{
+    auto reservation = reserveFront(timeout_duration);
+    if (not reservation.has_value()) {
+        return std::unexpected { reservation.error() };
+    }
+    return getCellElement(reservation->position);
+}
+
+auto RingBufferLockFreeMPMC::ReleaseFrontElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    auto sequence = getCellSequenceFromElement(element);
+    if (not sequence.has_value()) {
+        return std::unexpected { sequence.error() };
+    }
+    // The claimed cell's sequence still equals the claimed position
+    auto const position = (*sequence)->load(std::memory_order_relaxed);
+    (*sequence)->store(position + 1, std::memory_order_release);
+    return {};
+}
+
+auto RingBufferLockFreeMPMC::GetBackElementPtr(DurationUs timeout_duration)
+    -> std::expected<uint8_t const* const, PikaError>
+{
+    auto reservation = reserveBack(timeout_duration);
+    if (not reservation.has_value()) {
+        return std::unexpected { reservation.error() };
+    }
+    return getCellElement(reservation->position);
+}
+
+auto RingBufferLockFreeMPMC::ReleaseBackElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    auto sequence = getCellSequenceFromElement(element);
+    if (not sequence.has_value()) {
+        return std::unexpected { sequence.error() };
+    }
+    // The claimed cell's sequence still equals the claimed position + 1
+    auto const position = (*sequence)->load(std::memory_order_relaxed) - 1;
+    (*sequence)->store(position + m_queue_length, std::memory_order_release);
+    return {};
+}
+
+auto RingBufferLockFreeMPMC::PushFrontBatch(uint8_t const* const elements, uint64_t count,
+    DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (count == 0) {
+        return 0;
+    }
+    auto reservation = reserveFront(timeout_duration, count);
+    if (not reservation.has_value()) {
+        return std::unexpected { reservation.error() };
+    }
+    // The cells are interleaved with their sequence counters, each one is published on its own
+    for (uint64_t i = 0; i < reservation->count; ++i) {
+        auto const position = reservation->position + i;
+        std::memcpy(getCellElement(position), elements + (i * m_element_size_in_bytes),
+            m_element_size_in_bytes);
+        getCellSequence(position).store(position + 1, std::memory_order_release);
+    }
+    return reservation->count;
+}
+
+auto RingBufferLockFreeMPMC::PopBackBatch(uint8_t* const elements, uint64_t max_count,
+    uint64_t min_count, DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (max_count == 0) {
+        return 0;
+    }
+    auto reservation = reserveBack(timeout_duration, max_count, min_count);
+    if (not reservation.has_value()) {
+        return std::unexpected { reservation.error() };
+    }
+    for (uint64_t i = 0; i < reservation->count; ++i) {
+        auto const position = reservation->position + i;
+        std::memcpy(elements + (i * m_element_size_in_bytes), getCellElement(position),
+            m_element_size_in_bytes);
+        getCellSequence(position).store(position + m_queue_length, std::memory_order_release);
+    }
+    return reservation->count;
+}
+
+auto RingBufferBroadcast::Initialize(uint8_t* buffer, uint64_t element_size,
+    uint64_t element_alignment, uint64_t number_of_elements) -> std::expected<void, PikaError>
+{
+    setRingBuffer(buffer);
+    m_element_size_in_bytes = element_size;
+    m_element_alignment = element_alignment;
+    m_queue_length = number_of_elements;
+    m_index_mask = GetIndexMask(number_of_elements);
+    m_tail.store(0);
+    m_cached_slowest_cursor = 0;
+    for (auto& cursor : m_cursors) {
+        cursor.registered.store(false);
+        cursor.position.store(0);
+    }
+    return {};
+}
+
+auto RingBufferBroadcast::RegisterConsumer() -> std::expected<uint64_t, PikaError>
+{
+    for (uint64_t cursor_id = 0; cursor_id < MAX_CONSUMERS; ++cursor_id) {
+        auto& cursor = m_cursors[cursor_id];
+        bool registered = false;
+        if (not cursor.registered.compare_exchange_strong(registered, true)) {
+            continue;
+        }
+        // Until the position below is stored the producer may gate on the stale position of the
+        // cursor's previous owner, which is never ahead of the tail and therefore only makes the
+        // producer wait. A producer that scanned the cursors before the registration computed its
+        // limit from a slowest cursor at or behind the tail loaded here, so it cannot overwrite
+        // the slot this cursor starts at.
+        cursor.position.store(m_tail.load(std::memory_order_acquire), std::memory_order_release);
+        return cursor_id;
+    }
+    return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+        .error_message = fmt::format(
+            "Cannot register more than {} consumers on a broadcast channel", MAX_CONSUMERS) } };
+}
+
+auto RingBufferBroadcast::UnregisterConsumer(uint64_t cursor_id) -> void
+{
+    PIKA_ASSERT(cursor_id < MAX_CONSUMERS);
+    m_cursors[cursor_id].registered.store(false, std::memory_order_release);
+}
+
+auto RingBufferBroadcast::getSlowestCursor(uint64_t current_tail) -> uint64_t
+{
+    auto slowest_cursor = current_tail;
+    for (auto& cursor : m_cursors) {
+        if (cursor.registered.load(std::memory_order_acquire)) {
+            slowest_cursor
+                = std::min(slowest_cursor, cursor.position.load(std::memory_order_acquire));
+        }
+    }
+    return slowest_cursor;
+}
+
+auto RingBufferBroadcast::waitForFreeSlot(DurationUs timeout_duration)
+    -> std::expected<uint64_t, PikaError>
+{
+    auto const current_tail = m_tail.load(std::memory_order_relaxed);
+    if (current_tail - m_cached_slowest_cursor < m_queue_length) {
+        return current_tail;
+    }
+    // Cached cursor says the ring is full, rescan the consumers' cursors
+    std::optional<Timer> timer;
+    while (current_tail - (m_cached_slowest_cursor = getSlowestCursor(current_tail))
+        >= m_queue_length) {
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            if (not timer.has_value()) {
+                timer.emplace();
+            } else if (timer->GetElapsedDuration(timeout_duration) >= timeout_duration) {
+                return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                    .error_message = "RingBufferBroadcast: Timed out waiting for the slowest "
+                                     "consumer to free a slot" } };
+            }
+        }
+        std::this_thread::yield();
+    }
+    return current_tail;
+}
+
+auto RingBufferBroadcast::waitForElement(
+    uint64_t cursor_id, DurationUs timeout_duration, uint64_t min_count)
+    -> std::expected<uint64_t, PikaError>
+{
+    PIKA_ASSERT(cursor_id < MAX_CONSUMERS);
+    auto const position = m_cursors[cursor_id].position.load(std::memory_order_relaxed);
+    std::optional<Timer> timer;
+    while (m_tail.load(std::memory_order_acquire) - position < min_count) {
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            if (not timer.has_value()) {
+                timer.emplace();
+            } else if (timer->GetElapsedDuration(timeout_duration) >= timeout_duration) {
+                return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                    .error_message = "RingBufferBroadcast: Timed out waiting for an element" } };
+            }
+        }
+        std::this_thread::yield();
+    }
+    return position;
+}
+
+auto RingBufferBroadcast::PushFront(uint8_t const* const element, DurationUs timeout_duration)
+    -> std::expected<void, PikaError>
+{
+    auto current_tail = waitForFreeSlot(timeout_duration);
+    if (not current_tail.has_value()) {
+        return std::unexpected { current_tail.error() };
+    }
+    std::memcpy(getBufferSlot(getSlotIndex(*current_tail)), element, m_element_size_in_bytes);
+    m_tail.store(*current_tail + 1, std::memory_order_release);
+    return {};
+}
+
+auto RingBufferBroadcast::GetFrontElementPtr(DurationUs timeout_duration)
+    -> std::expected<uint8_t* const, PikaError>
+{
+    auto current_tail = waitForFreeSlot(timeout_duration);
+    if (not current_tail.has_value()) {
+        return std::unexpected { current_tail.error() };
+    }
+    // The slot at the tail is owned by the single producer until the tail is advanced
+    return getBufferSlot(getSlotIndex(*current_tail));
+}
+
+auto RingBufferBroadcast::ReleaseFrontElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    auto const current_tail = m_tail.load(std::memory_order_relaxed);
+    if (element != getBufferSlot(getSlotIndex(current_tail))) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to RingBufferBroadcast::ReleaseFrontElementPtr "
+                             "not the front pointer. Ensure that the pointer given to this "
+                             "function is the one obtained through "
+                             "RingBufferBroadcast::GetFrontElementPtr",
+        } };
+    }
+    // Publish the written slot to every consumer
+    m_tail.store(current_tail + 1, std::memory_order_release);
+    return {};
+}
+
+auto RingBufferBroadcast::PushFrontBatch(uint8_t const* const elements, uint64_t count,
+    DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (count == 0) {
+        return 0;
+    }
+    auto current_tail = waitForFreeSlot(timeout_duration);
+    if (not current_tail.has_value()) {
+        return std::unexpected { current_tail.error() };
+    }
+    auto const free_slots = m_queue_length - (*current_tail - m_cached_slowest_cursor);
+    auto const batch_size = std::min(count, free_slots);
+    copyToSlots(*current_tail, elements, batch_size);
+    m_tail.store(*current_tail + batch_size, std::memory_order_release);
+    return batch_size;
+}
+
+auto RingBufferBroadcast::PopBack(
+    uint64_t cursor_id, uint8_t* const element, DurationUs timeout_duration)
+    -> std::expected<void, PikaError>
+{
+    auto position = waitForElement(cursor_id, timeout_duration);
+    if (not position.has_value()) {
+        return std::unexpected { position.error() };
+    }
+    std::memcpy(element, getBufferSlot(getSlotIndex(*position)), m_element_size_in_bytes);
+    m_cursors[cursor_id].position.store(*position + 1, std::memory_order_release);
+    return {};
+}
+
+auto RingBufferBroadcast::GetBackElementPtr(uint64_t cursor_id, DurationUs timeout_duration)
+    -> std::expected<uint8_t const* const, PikaError>
+{
+    auto position = waitForElement(cursor_id, timeout_duration);
+    if (not position.has_value()) {
+        return std::unexpected { position.error() };
+    }
+    // The producer does not overwrite the slot until this cursor is advanced
+    return getBufferSlot(getSlotIndex(*position));
+}
+
+auto RingBufferBroadcast::ReleaseBackElementPtr(
+    uint64_t cursor_id, uint8_t const* const element) -> std::expected<void, PikaError>
+{
+    PIKA_ASSERT(cursor_id < MAX_CONSUMERS);
+    auto& cursor = m_cursors[cursor_id];
+    auto const position = cursor.position.load(std::memory_order_relaxed);
+    if (element != getBufferSlot(getSlotIndex(position))) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to RingBufferBroadcast::ReleaseBackElementPtr "
+                             "not the back pointer. Ensure that the pointer given to this "
+                             "function is the one obtained through "
+                             "RingBufferBroadcast::GetBackElementPtr",
+        } };
+    }
+    cursor.position.store(position + 1, std::memory_order_release);
+    return {};
+}
+
+auto RingBufferBroadcast::PopBackBatch(uint64_t cursor_id, uint8_t* const elements,
+    uint64_t max_count, uint64_t min_count, DurationUs timeout_duration)
+    -> std::expected<uint64_t, PikaError>
+{
+    if (max_count == 0) {
+        return 0;
+    }
+    auto position = waitForElement(cursor_id, timeout_duration, min_count);
+    if (not position.has_value()) {
+        return std::unexpected { position.error() };
+    }
+    auto const available = m_tail.load(std::memory_order_acquire) - *position;
+    auto const batch_size = std::min(max_count, available);
+    copyFromSlots(*position, elements, batch_size);
+    m_cursors[cursor_id].position.store(*position + batch_size, std::memory_order_release);
+    return batch_size;
+}
+
+static auto broadcastCursorRequiredError() -> PikaError
+{
+    return PikaError { .error_type = PikaErrorType::RingBufferError,
+        .error_message = "RingBufferBroadcast: Consumers must read through a registered cursor" };
+}
+
+auto RingBufferBroadcast::PopBack(uint8_t* const, DurationUs) -> std::expected<void, PikaError>
+{
+    return std::unexpected { broadcastCursorRequiredError() };
+}
+
+auto RingBufferBroadcast::GetBackElementPtr(DurationUs)
+    -> std::expected<uint8_t const* const, PikaError>
+{
+    return std::unexpected { broadcastCursorRequiredError() };
+}
+
+auto RingBufferBroadcast::ReleaseBackElementPtr(uint8_t const* const)
+    -> std::expected<void, PikaError>
+{
+    return std::unexpected { broadcastCursorRequiredError() };
+}
+
+auto RingBufferBroadcast::PopBackBatch(uint8_t* const, uint64_t, uint64_t, DurationUs)
+    -> std::expected<uint64_t, PikaError>
+{
+    return std::unexpected { broadcastCursorRequiredError() };
+}
+
+auto RingBufferBytes::Initialize(uint8_t* buffer, uint64_t element_size,
+    uint64_t element_alignment, uint64_t number_of_elements) -> std::expected<void, PikaError>
+{
+    if (element_size != 1 || element_alignment % RECORD_ALIGNMENT != 0
+        || number_of_elements % RECORD_ALIGNMENT != 0) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format("RingBufferBytes: The ring must be made of a multiple of "
+                                         "{} bytes aligned to {} bytes",
+                RECORD_ALIGNMENT, RECORD_ALIGNMENT) } };
+    }
+    setRingBuffer(buffer);
+    m_element_size_in_bytes = element_size;
+    m_element_alignment = element_alignment;
+    m_queue_length = number_of_elements;
+    m_index_mask = GetIndexMask(number_of_elements);
+    m_head.store(0);
+    m_tail.store(0);
+    m_cached_head = 0;
+    m_cached_tail = 0;
+    m_reserved_size = 0;
+    m_reserved = false;
+    m_parked_producers.store(0);
+    m_parked_consumers.store(0);
+    return {};
+}
+
+auto RingBufferBytes::SetWaitStrategy(pika::WaitStrategy const& wait_strategy) -> void
+{
+    m_wait_strategy = wait_strategy;
+}
+
+auto RingBufferBytes::waitForFreeBytes(uint64_t size, DurationUs timeout_duration)
+    -> std::expected<uint64_t, PikaError>
+{
+    auto const current_tail = m_tail.load(std::memory_order_relaxed);
+    if (current_tail - m_cached_head + size <= m_queue_length) {
+        return current_tail;
+    }
+    // Cached head says there is not enough room, refresh it from the consumer's cache line
+    Timer timer;
+    Backoff backoff { m_wait_strategy, m_head, m_parked_producers };
+    while (current_tail - (m_cached_head = m_head.load(std::memory_order_acquire)) + size
+        > m_queue_length) {
+        auto remaining_duration = pika::INFINITE_TIMEOUT;
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            auto const elapsed_duration = timer.GetElapsedDuration(timeout_duration);
+            if (elapsed_duration >= timeout_duration) {
+                return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                    .error_message = "RingBufferBytes: Timed out waiting for free space" } };
+            }
+            remaining_duration = timeout_duration - elapsed_duration;
+        }
+        backoff.Pause(m_cached_head, remaining_duration);
+    }
+    return current_tail;
+}
+
+auto RingBufferBytes::waitForRecord(DurationUs timeout_duration)
+    -> std::expected<uint64_t, PikaError>
+{
+    auto const current_head = m_head.load(std::memory_order_relaxed);
+    if (m_cached_tail != current_head) {
+        return current_head;
+    }
+    // Cached tail says the ring is empty, refresh it from the producer's cache line
+    Timer timer;
+    Backoff backoff { m_wait_strategy, m_tail, m_parked_consumers };
+    while ((m_cached_tail = m_tail.load(std::memory_order_acquire)) == current_head) {
+        auto remaining_duration = pika::INFINITE_TIMEOUT;
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            auto const elapsed_duration = timer.GetElapsedDuration(timeout_duration);
+            if (elapsed_duration >= timeout_duration) {
+                return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                    .error_message = "RingBufferBytes: Timed out waiting for a record" } };
+            }
+            remaining_duration = timeout_duration - elapsed_duration;
+        }
+        backoff.Pause(m_cached_tail, remaining_duration);
+    }
+    return current_head;
+}
+
+auto RingBufferBytes::ReserveBytes(uint64_t size, DurationUs timeout_duration)
+    -> std::expected<uint8_t* const, PikaError>
+{
+    if (m_reserved) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "RingBufferBytes: CommitBytes must be called before reserving "
+                             "another record" } };
+    }
+    auto const record_size = GetRecordSize(size);
+    if (record_size > m_queue_length) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format("RingBufferBytes: A record of {} bytes does not fit in "
+                                         "a ring of {} bytes",
+                record_size, m_queue_length) } };
+    }
+    std::optional<Timer> timer;
+    auto current_tail = m_tail.load(std::memory_order_relaxed);
+    auto const contiguous_size = m_queue_length - getSlotIndex(current_tail);
+    if (not m_mirrored_mapping && record_size > contiguous_size) {
+        // Fill the end of the ring with a padding record so that the record starts at slot 0.
+        // Waiting for the padding and the record together keeps a timeout from modifying the ring.
+        // When both do not fit in the ring at once the padding has to be published before the
+        // record's space can free up, a wrapping reservation may then time out after publishing
+        // the padding, which the consumer skips.
+        auto const padding_wait_size = contiguous_size + record_size <= m_queue_length
+            ? contiguous_size + record_size
+            : contiguous_size;
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            timer.emplace();
+        }
+        auto padding_tail = waitForFreeBytes(padding_wait_size, timeout_duration);
+        if (not padding_tail.has_value()) {
+            return std::unexpected { padding_tail.error() };
+        }
+        *getLengthWord(current_tail) = PADDING_RECORD_FLAG | contiguous_size;
+        current_tail += contiguous_size;
+        m_tail.store(current_tail, std::memory_order_release);
+        Backoff::WakeParked(m_wait_strategy, m_tail, m_parked_consumers);
+    }
+    auto remaining_duration = timeout_duration;
+    if (timer.has_value()) {
+        auto const elapsed_duration = timer->GetElapsedDuration(timeout_duration);
+        remaining_duration
+            = elapsed_duration < timeout_duration ? timeout_duration - elapsed_duration : 0;
+    }
+    auto record_tail = waitForFreeBytes(record_size, remaining_duration);
+    if (not record_tail.has_value()) {
+        return std::unexpected { record_tail.error() };
+    }
+    m_reserved_size = size;
+    m_reserved = true;
+    // The record is owned by the single producer until the tail is advanced
+    return getBufferSlot(getSlotIndex(current_tail)) + sizeof(uint64_t);
+}
+
+auto RingBufferBytes::CommitBytes(uint8_t const* const payload) -> std::expected<void, PikaError>
+{
+    auto const current_tail = m_tail.load(std::memory_order_relaxed);
+    if (not m_reserved
+        || payload != getBufferSlot(getSlotIndex(current_tail)) + sizeof(uint64_t)) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Payload pointer given to RingBufferBytes::CommitBytes not the "
+                             "reserved record. Ensure that the pointer given to this function is "
+                             "the one obtained through RingBufferBytes::ReserveBytes",
+        } };
+    }
+    *getLengthWord(current_tail) = m_reserved_size;
+    m_reserved = false;
+    // Publish the record to the consumer
+    m_tail.store(current_tail + GetRecordSize(m_reserved_size), std::memory_order_release);
+    Backoff::WakeParked(m_wait_strategy, m_tail, m_parked_consumers);
+    return {};
+}
+
+auto RingBufferBytes::PushBytes(uint8_t const* const source, uint64_t size,
+    DurationUs timeout_duration) -> std::expected<void, PikaError>
+{
+    auto payload = ReserveBytes(size, timeout_duration);
+    if (not payload.has_value()) {
+        return std::unexpected { payload.error() };
+    }
+    std::memcpy(*payload, source, size);
+    return CommitBytes(*payload);
+}
+
+auto RingBufferBytes::waitForPayloadRecord(DurationUs timeout_duration)
+    -> std::expected<uint64_t, PikaError>
+{
+    std::optional<Timer> timer;
+    if (timeout_duration != pika::INFINITE_TIMEOUT) {
+        timer.emplace();
+    }
+    while (true) {
+        auto remaining_duration = timeout_duration;
+        if (timer.has_value()) {
+            auto const elapsed_duration = timer->GetElapsedDuration(timeout_duration);
+            remaining_duration
+                = elapsed_duration < timeout_duration ? timeout_duration - elapsed_duration : 0;
+        }
+        auto current_head = waitForRecord(remaining_duration);
+        if (not current_head.has_value()) {
+            return std::unexpected { current_head.error() };
+        }
+        auto const length_word = *getLengthWord(*current_head);
+        if ((length_word & PADDING_RECORD_FLAG) == 0) {
+            return *current_head;
+        }
+        // Skip the unused end of the ring
+        m_head.store(
+            *current_head + (length_word & ~PADDING_RECORD_FLAG), std::memory_order_release);
+        Backoff::WakeParked(m_wait_strategy, m_head, m_parked_producers);
+    }
+}
+
+auto RingBufferBytes::PopBytes(uint8_t* const destination, uint64_t destination_size,
+    DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    auto current_head = waitForPayloadRecord(timeout_duration);
+    if (not current_head.has_value()) {
+        return std::unexpected { current_head.error() };
+    }
+    auto const length_word = *getLengthWord(*current_head);
+    if (length_word > destination_size) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format("RingBufferBytes: Record of {} bytes does not fit in the "
+                                         "destination buffer of {} bytes",
+                length_word, destination_size) } };
+    }
+    std::memcpy(destination, getBufferSlot(getSlotIndex(*current_head)) + sizeof(uint64_t),
+        length_word);
+    m_head.store(*current_head + GetRecordSize(length_word), std::memory_order_release);
+    Backoff::WakeParked(m_wait_strategy, m_head, m_parked_producers);
+    return length_word;
+}
+
+auto RingBufferBytes::PeekBytes(DurationUs timeout_duration)
+    -> std::expected<std::span<uint8_t const>, PikaError>
+{
+    auto current_head = waitForPayloadRecord(timeout_duration);
+    if (not current_head.has_value()) {
+        return std::unexpected { current_head.error() };
+    }
+    // The record is owned by the single consumer until the head is advanced
+    return std::span<uint8_t const>(
+        getBufferSlot(getSlotIndex(*current_head)) + sizeof(uint64_t),
+        *getLengthWord(*current_head));
+}
+
+auto RingBufferBytes::ReleaseBytes(uint8_t const* const payload) -> std::expected<void, PikaError>
+{
+    auto const current_head = m_head.load(std::memory_order_relaxed);
+    if (current_head == m_cached_tail
+        || payload != getBufferSlot(getSlotIndex(current_head)) + sizeof(uint64_t)) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Payload pointer given to RingBufferBytes::ReleaseBytes not the "
+                             "next record. Ensure that the pointer given to this function is "
+                             "the one obtained through RingBufferBytes::PeekBytes",
+        } };
+    }
+    m_head.store(
+        current_head + GetRecordSize(*getLengthWord(current_head)), std::memory_order_release);
+    Backoff::WakeParked(m_wait_strategy, m_head, m_parked_producers);
+    return {};
+}
+
+static auto byteStreamOnlyError() -> PikaError
+{
+    return PikaError { .error_type = PikaErrorType::RingBufferError,
+        .error_message = "RingBufferBytes: Byte stream channels only transfer variable length "
+                         "records" };
+}
+
+auto RingBufferBytes::PushFront(uint8_t const* const, DurationUs)
+    -> std::expected<void, PikaError>
+{
+    return std::unexpected { byteStreamOnlyError() };
+}
+
+auto RingBufferBytes::PopBack(uint8_t* const, DurationUs) -> std::expected<void, PikaError>
+{
+    return std::unexpected { byteStreamOnlyError() };
+}
+
+auto RingBufferBytes::GetFrontElementPtr(DurationUs) -> std::expected<uint8_t* const, PikaError>
+{
+    return std::unexpected { byteStreamOnlyError() };
+}
+
+auto RingBufferBytes::ReleaseFrontElementPtr(uint8_t const* const)
+    -> std::expected<void, PikaError>
+{
+    return std::unexpected { byteStreamOnlyError() };
+}
+
+auto RingBufferBytes::GetBackElementPtr(DurationUs)
+    -> std::expected<uint8_t const* const, PikaError>
+{
+    return std::unexpected { byteStreamOnlyError() };
+}
+
+auto RingBufferBytes::ReleaseBackElementPtr(uint8_t const* const)
+    -> std::expected<void, PikaError>
+{
+    return std::unexpected { byteStreamOnlyError() };
+}
+
+auto RingBufferBytes::PushFrontBatch(uint8_t const* const, uint64_t, DurationUs)
+    -> std::expected<uint64_t, PikaError>
+{
+    return std::unexpected { byteStreamOnlyError() };
+}
+
+auto RingBufferBytes::PopBackBatch(uint8_t* const, uint64_t, uint64_t, DurationUs)
+    -> std::expected<uint64_t, PikaError>
+{
+    return std::unexpected { byteStreamOnlyError() };
+}
+
+auto RingBufferConflating::Initialize(uint8_t* buffer, uint64_t element_size,
+    uint64_t element_alignment, uint64_t number_of_elements) -> std::expected<void, PikaError>
+{
+    if (buffer == nullptr) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "RingBufferConflating::Initialize buffer==nullptr" });
+    }
+    if (number_of_elements == 0) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "RingBufferConflating::Initialize queue length must be non-zero" });
+    }
+    // The slots offset is only guaranteed to be aligned to the element alignment, the cells
+    // additionally need to be aligned for their sequence counters.
+    auto const cell_alignment = GetCellAlignment(element_alignment);
+    auto const misalignment = reinterpret_cast<std::uintptr_t>(buffer) % cell_alignment;
+    if (misalignment != 0) {
+        buffer += cell_alignment - misalignment;
+    }
+    setRingBuffer(buffer);
+    m_element_size_in_bytes = element_size;
+    m_element_alignment = element_alignment;
+    m_queue_length = number_of_elements;
+    m_index_mask = GetIndexMask(number_of_elements);
+    m_cell_stride = GetCellStride(element_size, element_alignment);
+    m_element_offset = cell_alignment;
+    for (uint64_t sequence_number = 1; sequence_number <= m_queue_length; ++sequence_number) {
+        new (&getCellSequence(sequence_number)) std::atomic_uint64_t { 0 };
+    }
+    m_latest.store(0);
+    m_write_in_progress = false;
+    return {};
+}
+
+auto RingBufferConflating::beginWrite() -> uint64_t
+{
+    auto const sequence_number = m_latest.load(std::memory_order_relaxed) + 1;
+    getCellSequence(sequence_number)
+        .store(getStableCellSequence(sequence_number) - 1, std::memory_order_relaxed);
+    // Keeps the writes to the element from being reordered before the odd counter
+    std::atomic_thread_fence(std::memory_order_release);
+    m_write_in_progress = true;
+    return sequence_number;
+}
+
+auto RingBufferConflating::endWrite(uint64_t sequence_number) -> void
+{
+    getCellSequence(sequence_number)
+        .store(getStableCellSequence(sequence_number), std::memory_order_release);
+    m_latest.store(sequence_number, std::memory_order_release);
+    m_write_in_progress = false;
+}
+
+auto RingBufferConflating::PushFront(uint8_t const* const element, DurationUs)
+    -> std::expected<void, PikaError>
+{
+    if (m_write_in_progress) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "RingBufferConflating: ReleaseFrontElementPtr must be called "
+                             "before publishing another value" } };
+    }
+    auto const sequence_number = beginWrite();
+    std::memcpy(getCellElement(sequence_number), element, m_element_size_in_bytes);
+    endWrite(sequence_number);
+    return {};
+}
+
+auto RingBufferConflating::GetFrontElementPtr(DurationUs)
+    -> std::expected<uint8_t* const, PikaError>
+{
+    if (m_write_in_progress) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "RingBufferConflating: ReleaseFrontElementPtr must be called "
+                             "before publishing another value" } };
+    }
+    // Readers of this cell retry until the element is released
+    return getCellElement(beginWrite());
+}
+
+auto RingBufferConflating::ReleaseFrontElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    auto const sequence_number = m_latest.load(std::memory_order_relaxed) + 1;
+    if (not m_write_in_progress || element != getCellElement(sequence_number)) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message
+            = "Element pointer given to RingBufferConflating::ReleaseFrontElementPtr not the "
+              "front pointer. Ensure that the pointer given to this function is the one "
+              "obtained through RingBufferConflating::GetFrontElementPtr",
+        } };
+    }
+    endWrite(sequence_number);
+    return {};
+}
+
+auto RingBufferConflating::PushFrontBatch(uint8_t const* const elements, uint64_t count,
+    DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (count == 0) {
+        return 0;
+    }
+    auto result
+        = PushFront(elements + ((count - 1) * m_element_size_in_bytes), timeout_duration);
+    if (not result.has_value()) {
+        return std::unexpected { result.error() };
+    }
+    return count;
+}
+
+auto RingBufferConflating::ReadLatest(uint8_t* const element, uint64_t last_sequence_number,
+    DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    std::optional<Timer> timer;
+    while (true) {
+        auto const sequence_number = m_latest.load(std::memory_order_acquire);
+        if (sequence_number <= last_sequence_number) {
+            // Nothing newer than what the reader has already seen
+            if (timeout_duration != pika::INFINITE_TIMEOUT) {
+                if (not timer.has_value()) {
+                    timer.emplace();
+                } else if (timer->GetElapsedDuration(timeout_duration) >= timeout_duration) {
+                    return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                        .error_message = "RingBufferConflating: Timed out waiting for a new "
+                                         "value" } };
+                }
+            }
+            std::this_thread::yield();
+            continue;
+        }
+        auto& cell_sequence = getCellSequence(sequence_number);
+        auto const stable_sequence = getStableCellSequence(sequence_number);
+        if (cell_sequence.load(std::memory_order_acquire) == stable_sequence) {
+            std::memcpy(element, getCellElement(sequence_number), m_element_size_in_bytes);
+            // Keeps the reads of the element from being reordered after the counter re-check
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (cell_sequence.load(std::memory_order_relaxed) == stable_sequence) {
+                return sequence_number;
+            }
+        }
+        // The producer lapped the ring and is rewriting this cell, retry with the latest value
+    }
+}
+
+static auto conflatingSequenceRequiredError() -> PikaError
+{
+    return PikaError { .error_type = PikaErrorType::RingBufferError,
+        .error_message
+        = "RingBufferConflating: Consumers must read through RingBufferConflating::ReadLatest" };
+}
+
+auto RingBufferConflating::PopBack(uint8_t* const, DurationUs) -> std::expected<void, PikaError>
+{
+    return std::unexpected { conflatingSequenceRequiredError() };
+}
+
+auto RingBufferConflating::GetBackElementPtr(DurationUs)
+    -> std::expected<uint8_t const* const, PikaError>
+{
+    // The value could be overwritten while the caller holds the pointer
+    return std::unexpected { conflatingSequenceRequiredError() };
+}
+
+auto RingBufferConflating::ReleaseBackElementPtr(uint8_t const* const)
+    -> std::expected<void, PikaError>
+{
+    return std::unexpected { conflatingSequenceRequiredError() };
+}
+
+auto RingBufferConflating::PopBackBatch(uint8_t* const, uint64_t, uint64_t, DurationUs)
+    -> std::expected<uint64_t, PikaError>
+{
+    return std::unexpected { conflatingSequenceRequiredError() };
+}
+
+auto RingBufferTripleBuffer::Initialize(uint8_t* buffer, uint64_t element_size,
+    uint64_t element_alignment, uint64_t number_of_elements) -> std::expected<void, PikaError>
+{
+    if (number_of_elements != NUMBER_OF_BUFFERS) {
+        return std::unexpected(PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = fmt::format("RingBufferTripleBuffer::Initialize queue length must be "
+                                         "{}",
+                NUMBER_OF_BUFFERS) });
+    }
+    setRingBuffer(buffer);
+    m_element_size_in_bytes = element_size;
+    m_element_alignment = element_alignment;
+    m_queue_length = number_of_elements;
+    m_index_mask = GetIndexMask(number_of_elements);
+    m_back = 0;
+    m_middle.store(1);
+    m_front = 2;
+    return {};
+}
+
+auto RingBufferTripleBuffer::publishBack() -> void
+{
+    // Release the written back buffer and take over the previous middle buffer, fresh or not
+    auto const previous_middle = m_middle.exchange(
+        static_cast<uint8_t>(m_back | FRESH_FLAG), std::memory_order_acq_rel);
+    m_back = previous_middle & INDEX_MASK;
+}
+
+auto RingBufferTripleBuffer::acquireFront(DurationUs timeout_duration)
+    -> std::expected<uint8_t*, PikaError>
+{
+    std::optional<Timer> timer;
+    while ((m_middle.load(std::memory_order_relaxed) & FRESH_FLAG) == 0) {
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            if (not timer.has_value()) {
+                timer.emplace();
+            } else if (timer->GetElapsedDuration(timeout_duration) >= timeout_duration) {
+                return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                    .error_message = "RingBufferTripleBuffer: Timed out waiting for a new "
+                                     "element" } };
+            }
+        }
+        std::this_thread::yield();
+    }
+    // Only the consumer clears the fresh flag, the middle buffer stays fresh until the exchange
+    auto const previous_middle = m_middle.exchange(m_front, std::memory_order_acq_rel);
+    m_front = previous_middle & INDEX_MASK;
+    return getBufferSlot(m_front);
+}
+
+auto RingBufferTripleBuffer::PushFront(uint8_t const* const element, DurationUs)
+    -> std::expected<void, PikaError>
+{
+    std::memcpy(getBufferSlot(m_back), element, m_element_size_in_bytes);
+    publishBack();
+    return {};
+}
+
+auto RingBufferTripleBuffer::PopBack(uint8_t* const element, DurationUs timeout_duration)
+    -> std::expected<void, PikaError>
+{
+    auto front = acquireFront(timeout_duration);
+    if (not front.has_value()) {
+        return std::unexpected { front.error() };
+    }
+    std::memcpy(element, *front, m_element_size_in_bytes);
+    return {};
+}
+
+auto RingBufferTripleBuffer::GetFrontElementPtr(DurationUs)
+    -> std::expected<uint8_t* const, PikaError>
+{
+    // The back buffer is always free
+    return getBufferSlot(m_back);
+}
+
+auto RingBufferTripleBuffer::ReleaseFrontElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    if (element != getBufferSlot(m_back)) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to "
+                             "RingBufferTripleBuffer::ReleaseFrontElementPtr not the back buffer. "
+                             "Ensure that the pointer given to this function is the one obtained "
+                             "through RingBufferTripleBuffer::GetFrontElementPtr",
+        } };
+    }
+    publishBack();
+    return {};
+}
+
+auto RingBufferTripleBuffer::GetBackElementPtr(DurationUs timeout_duration)
+    -> std::expected<uint8_t const* const, PikaError>
+{
+    auto front = acquireFront(timeout_duration);
+    if (not front.has_value()) {
+        return std::unexpected { front.error() };
+    }
+    return *front;
+}
+
+auto RingBufferTripleBuffer::ReleaseBackElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    if (element != getBufferSlot(m_front)) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to "
+                             "RingBufferTripleBuffer::ReleaseBackElementPtr not the front buffer. "
+                             "Ensure that the pointer given to this function is the one obtained "
+                             "through RingBufferTripleBuffer::GetBackElementPtr",
+        } };
+    }
+    // The front buffer is only handed back to the producer by the next acquireFront
+    return {};
+}
+
+auto RingBufferTripleBuffer::PushFrontBatch(uint8_t const* const elements, uint64_t count,
+    DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (count == 0) {
+        return 0;
+    }
+    auto result
+        = PushFront(elements + ((count - 1) * m_element_size_in_bytes), timeout_duration);
+    if (not result.has_value()) {
+        return std::unexpected { result.error() };
+    }
+    return count;
+}
+
+auto RingBufferTripleBuffer::PopBackBatch(uint8_t* const elements, uint64_t max_count,
+    uint64_t min_count, DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (max_count == 0) {
+        return 0;
+    }
+    if (min_count > 1) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
+            .error_message = "RingBufferTripleBuffer: Only the latest element is available, "
+                             "min_count must not exceed 1" } };
+    }
+    auto result = PopBack(elements, timeout_duration);
+    if (not result.has_value()) {
+        return std::unexpected { result.error() };
+    }
+    return 1;
+}
+
+auto RingBufferProducerLanes::Initialize(uint8_t* buffer, uint64_t element_size,
+    uint64_t element_alignment, uint64_t number_of_elements) -> std::expected<void, PikaError>
+{
+    setRingBuffer(buffer);
+    m_element_size_in_bytes = element_size;
+    m_element_alignment = element_alignment;
+    m_queue_length = number_of_elements;
+    m_index_mask = GetIndexMask(number_of_elements);
+    m_lane_size_in_bytes = number_of_elements * element_size;
+    m_lane_count.store(0);
+    m_next_lane = 0;
+    m_held_lane = 0;
+    for (auto& lane : m_lanes) {
+        lane.registered.store(false);
+        lane.tail.store(0);
+        lane.cached_head = 0;
+        lane.head.store(0);
+    }
+    return {};
+}
+
+auto RingBufferProducerLanes::RegisterProducer() -> std::expected<uint64_t, PikaError>
+{
+    for (uint64_t lane_id = 0; lane_id < MAX_PRODUCERS; ++lane_id) {
+        bool registered = false;
+        if (not m_lanes[lane_id].registered.compare_exchange_strong(registered, true)) {
+            continue;
+        }
+        // The previous owner may have left elements behind, pick up from its head
+        m_lanes[lane_id].cached_head = m_lanes[lane_id].head.load(std::memory_order_acquire);
+        auto lane_count = m_lane_count.load();
+        while (lane_count <= lane_id
+            && not m_lane_count.compare_exchange_weak(lane_count, lane_id + 1)) { }
+        return lane_id;
+    }
+    return std::unexpected { PikaError { .error_type = PikaErrorType::ChannelError,
+        .error_message = fmt::format(
+            "Cannot register more than {} producers on a producer lanes channel",
+            MAX_PRODUCERS) } };
+}
+
+auto RingBufferProducerLanes::UnregisterProducer(uint64_t lane_id) -> void
+{
+    PIKA_ASSERT(lane_id < MAX_PRODUCERS);
+    // Publishes the lane's tail to the next owner
+    m_lanes[lane_id].registered.store(false, std::memory_order_release);
+}
+
+auto RingBufferProducerLanes::waitForFreeSlot(uint64_t lane_id, DurationUs timeout_duration)
+    -> std::expected<uint64_t, PikaError>
+{
+    PIKA_ASSERT(lane_id < MAX_PRODUCERS);
+    auto& lane = m_lanes[lane_id];
+    auto const current_tail = lane.tail.load(std::memory_order_relaxed);
+    std::optional<Timer> timer;
+    while (current_tail - lane.cached_head >= m_queue_length) {
+        lane.cached_head = lane.head.load(std::memory_order_acquire);
+        if (current_tail - lane.cached_head < m_queue_length) {
+            break;
+        }
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            if (not timer.has_value()) {
+                timer.emplace();
+            } else if (timer->GetElapsedDuration(timeout_duration) >= timeout_duration) {
+                return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                    .error_message = "RingBufferProducerLanes: Timed out waiting for a free "
+                                     "slot" } };
+            }
+        }
+        std::this_thread::yield();
+    }
+    return current_tail;
+}
+
+auto RingBufferProducerLanes::waitForElement(DurationUs timeout_duration, uint64_t min_count)
+    -> std::expected<uint64_t, PikaError>
+{
+    std::optional<Timer> timer;
+    while (true) {
+        auto const lane_count = m_lane_count.load(std::memory_order_acquire);
+        uint64_t available_count = 0;
+        std::optional<uint64_t> first_ready_lane;
+        for (uint64_t i = 0; i < lane_count && available_count < min_count; ++i) {
+            auto const lane_id = (m_next_lane + i) % lane_count;
+            auto& lane = m_lanes[lane_id];
+            auto const lane_size = lane.tail.load(std::memory_order_acquire)
+                - lane.head.load(std::memory_order_relaxed);
+            if (lane_size != 0 && not first_ready_lane.has_value()) {
+                first_ready_lane = lane_id;
+            }
+            available_count += lane_size;
+        }
+        if (available_count >= min_count && first_ready_lane.has_value()) {
+            return *first_ready_lane;
+        }
+        if (timeout_duration != pika::INFINITE_TIMEOUT) {
+            if (not timer.has_value()) {
+                timer.emplace();
+            } else if (timer->GetElapsedDuration(timeout_duration) >= timeout_duration) {
+                return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                    .error_message
+                    = "RingBufferProducerLanes: Timed out waiting for an element" } };
+            }
+        }
+        std::this_thread::yield();
+    }
+}
+
+auto RingBufferProducerLanes::popFromLane(
+    uint64_t lane_id, uint8_t* const elements, uint64_t count) -> void
+{
+    auto& lane = m_lanes[lane_id];
+    auto const current_head = lane.head.load(std::memory_order_relaxed);
+    for (uint64_t i = 0; i < count; ++i) {
+        std::memcpy(elements + (i * m_element_size_in_bytes),
+            getLaneSlot(lane_id, current_head + i), m_element_size_in_bytes);
+    }
+    lane.head.store(current_head + count, std::memory_order_release);
+}
+
+auto RingBufferProducerLanes::PushFront(uint64_t lane_id, uint8_t const* const element,
+    DurationUs timeout_duration) -> std::expected<void, PikaError>
+{
+    auto current_tail = waitForFreeSlot(lane_id, timeout_duration);
+    if (not current_tail.has_value()) {
+        return std::unexpected { current_tail.error() };
+    }
+    std::memcpy(getLaneSlot(lane_id, *current_tail), element, m_element_size_in_bytes);
+    m_lanes[lane_id].tail.store(*current_tail + 1, std::memory_order_release);
+    return {};
+}
+
+auto RingBufferProducerLanes::GetFrontElementPtr(uint64_t lane_id, DurationUs timeout_duration)
+    -> std::expected<uint8_t* const, PikaError>
+{
+    auto current_tail = waitForFreeSlot(lane_id, timeout_duration);
+    if (not current_tail.has_value()) {
+        return std::unexpected { current_tail.error() };
+    }
+    return getLaneSlot(lane_id, *current_tail);
+}
+
+auto RingBufferProducerLanes::ReleaseFrontElementPtr(
+    uint64_t lane_id, uint8_t const* const element) -> std::expected<void, PikaError>
+{
+    PIKA_ASSERT(lane_id < MAX_PRODUCERS);
+    auto& lane = m_lanes[lane_id];
+    auto const current_tail = lane.tail.load(std::memory_order_relaxed);
+    if (element != getLaneSlot(lane_id, current_tail)) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to "
+                             "RingBufferProducerLanes::ReleaseFrontElementPtr not the front of "
+                             "the lane. Ensure that the pointer given to this function is the "
+                             "one obtained through RingBufferProducerLanes::GetFrontElementPtr",
+        } };
+    }
+    lane.tail.store(current_tail + 1, std::memory_order_release);
+    return {};
+}
+
+auto RingBufferProducerLanes::PushFrontBatch(uint64_t lane_id, uint8_t const* const elements,
+    uint64_t count, DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (count == 0) {
+        return 0;
+    }
+    auto current_tail = waitForFreeSlot(lane_id, timeout_duration);
+    if (not current_tail.has_value()) {
+        return std::unexpected { current_tail.error() };
+    }
+    auto& lane = m_lanes[lane_id];
+    auto const push_count = std::min(count, m_queue_length - (*current_tail - lane.cached_head));
+    for (uint64_t i = 0; i < push_count; ++i) {
+        std::memcpy(getLaneSlot(lane_id, *current_tail + i),
+            elements + (i * m_element_size_in_bytes), m_element_size_in_bytes);
+    }
+    lane.tail.store(*current_tail + push_count, std::memory_order_release);
+    return push_count;
+}
+
+auto RingBufferProducerLanes::PopBack(uint8_t* const element, DurationUs timeout_duration)
+    -> std::expected<void, PikaError>
+{
+    auto lane_id = waitForElement(timeout_duration);
+    if (not lane_id.has_value()) {
+        return std::unexpected { lane_id.error() };
+    }
+    popFromLane(*lane_id, element, 1);
+    m_next_lane = *lane_id + 1;
+    return {};
+}
+
+auto RingBufferProducerLanes::GetBackElementPtr(DurationUs timeout_duration)
+    -> std::expected<uint8_t const* const, PikaError>
+{
+    auto lane_id = waitForElement(timeout_duration);
+    if (not lane_id.has_value()) {
+        return std::unexpected { lane_id.error() };
+    }
+    m_held_lane = *lane_id;
+    return getLaneSlot(*lane_id, m_lanes[*lane_id].head.load(std::memory_order_relaxed));
+}
+
+auto RingBufferProducerLanes::ReleaseBackElementPtr(uint8_t const* const element)
+    -> std::expected<void, PikaError>
+{
+    auto& lane = m_lanes[m_held_lane];
+    auto const current_head = lane.head.load(std::memory_order_relaxed);
+    if (current_head == lane.tail.load(std::memory_order_acquire)
+        || element != getLaneSlot(m_held_lane, current_head)) {
+        return std::unexpected { PikaError {
+            .error_type = PikaErrorType::RingBufferError,
+            .error_message = "Element pointer given to "
+                             "RingBufferProducerLanes::ReleaseBackElementPtr not the back of the "
+                             "lane. Ensure that the pointer given to this function is the one "
+                             "obtained through RingBufferProducerLanes::GetBackElementPtr",
+        } };
+    }
+    lane.head.store(current_head + 1, std::memory_order_release);
+    m_next_lane = m_held_lane + 1;
+    return {};
+}
+
+auto RingBufferProducerLanes::PopBackBatch(uint8_t* const elements, uint64_t max_count,
+    uint64_t min_count, DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+{
+    if (max_count == 0) {
+        return 0;
+    }
+    auto first_lane = waitForElement(timeout_duration, std::max<uint64_t>(min_count, 1));
+    if (not first_lane.has_value()) {
+        return std::unexpected { first_lane.error() };
+    }
+    // Drain the lanes round-robin, starting at the first one that is not empty
+    auto const lane_count = m_lane_count.load(std::memory_order_acquire);
+    uint64_t popped_count = 0;
+    for (uint64_t i = 0; i < lane_count && popped_count < max_count; ++i) {
+        auto const lane_id = (*first_lane + i) % lane_count;
+        auto& lane = m_lanes[lane_id];
+        auto const lane_size = lane.tail.load(std::memory_order_acquire)
+            - lane.head.load(std::memory_order_relaxed);
+        auto const pop_count = std::min(lane_size, max_count - popped_count);
+        if (pop_count == 0) {
+            continue;
+        }
+        popFromLane(lane_id, elements + (popped_count * m_element_size_in_bytes), pop_count);
+        popped_count += pop_count;
+        m_next_lane = lane_id + 1;
+    }
+    return popped_count;
+}
+
+static auto producerLaneRequiredError() -> PikaError
+{
+    return PikaError { .error_type = PikaErrorType::RingBufferError,
+        .error_message = "RingBufferProducerLanes: Producers must push through their lane" };
+}
+
+auto RingBufferProducerLanes::PushFront(uint8_t const* const, DurationUs)
+    -> std::expected<void, PikaError>
+{
+    return std::unexpected { producerLaneRequiredError() };
+}
+
+auto RingBufferProducerLanes::GetFrontElementPtr(DurationUs)
+    -> std::expected<uint8_t* const, PikaError>
+{
+    return std::unexpected { producerLaneRequiredError() };
+}
+
+auto RingBufferProducerLanes::ReleaseFrontElementPtr(uint8_t const* const)
+    -> std::expected<void, PikaError>
+{
+    return std::unexpected { producerLaneRequiredError() };
+}
+
+auto RingBufferProducerLanes::PushFrontBatch(uint8_t const* const, uint64_t, DurationUs)
+    -> std::expected<uint64_t, PikaError>
+{
+    return std::unexpected { producerLaneRequiredError() };
+}
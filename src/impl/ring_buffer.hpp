@@ -26,14 +26,19 @@
 #include "channel_interface.hpp"
 #include "error.hpp"
 #include "synchronization_primitives.hpp"
+#include "utils.hpp"
 // System includes
 #include <__expected/unexpected.h>
+#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <concepts>
 #include <cstddef>
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <expected>
+#include <span>
 #include <type_traits>
 
 using namespace pika;
@@ -67,25 +72,110 @@ struct RingBufferBase {
         -> std::expected<void, PikaError>
         = 0;
     //*****************************************************************************************//
+    // Waits for at least one free slot and pushes as many of the count elements as fit with a
+    // single publish. Returns the number of elements pushed.
+    [[nodiscard]] virtual auto PushFrontBatch(uint8_t const* const elements, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+        = 0;
+    // Waits for at least min_count elements and pops up to max_count of them with a single
+    // publish. Returns the number of elements popped.
+    [[nodiscard]] virtual auto PopBackBatch(uint8_t* const elements, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>
+        = 0;
+    //*****************************************************************************************//
     [[nodiscard]] auto GetElementAlignment() const -> uint64_t { return m_element_alignment; }
     [[nodiscard]] auto GetElementSizeInBytes() const -> uint64_t { return m_element_size_in_bytes; }
     [[nodiscard]] auto GetQueueLength() -> uint64_t { return m_queue_length; }
+    // Queue lengths that are a power of two are indexed with a mask instead of a division
+    [[nodiscard]] static constexpr auto GetIndexMask(uint64_t queue_length) -> uint64_t
+    {
+        return std::has_single_bit(queue_length) ? queue_length - 1 : 0;
+    }
+    // Layout of rings whose slots are cells prefixed by a sequence counter:
+    // [sequence counter | padding | element | padding]
+    [[nodiscard]] static constexpr auto GetCellAlignment(uint64_t element_alignment) -> uint64_t
+    {
+        return element_alignment > sizeof(std::atomic_uint64_t) ? element_alignment
+                                                                : sizeof(std::atomic_uint64_t);
+    }
+    [[nodiscard]] static constexpr auto GetCellStride(
+        uint64_t element_size, uint64_t element_alignment) -> uint64_t
+    {
+        auto const cell_alignment = GetCellAlignment(element_alignment);
+        auto const unaligned_size = cell_alignment + element_size;
+        return ((unaligned_size + cell_alignment - 1) / cell_alignment) * cell_alignment;
+    }
+    // Set when the slots are mapped a second time right after the last slot, runs of slots
+    // crossing the end of the ring are then contiguous in memory
+    auto SetMirroredMapping(bool mirrored_mapping) -> void
+    {
+        m_mirrored_mapping = mirrored_mapping;
+    }
+    [[nodiscard]] auto IsMirroredMapping() const -> bool { return m_mirrored_mapping; }
 
 protected:
     [[nodiscard]] auto getBufferSlot(uint64_t index) -> uint8_t*
     {
         PIKA_ASSERT(index < m_queue_length);
-        return m_ring_buffer + (index * m_element_size_in_bytes);
+        return getRingBuffer() + (index * m_element_size_in_bytes);
+    }
+    // Maps a free running 64-bit counter to a slot index
+    [[nodiscard]] auto getSlotIndex(uint64_t counter) const -> uint64_t
+    {
+        return m_index_mask != 0 ? (counter & m_index_mask) : (counter % m_queue_length);
     }
-    uint8_t* m_ring_buffer = nullptr;
+    // Copy count elements to/from the slots starting at counter; a run of slots crossing the end
+    // of the ring is copied in two segments
+    auto copyToSlots(uint64_t counter, uint8_t const* const elements, uint64_t count) -> void
+    {
+        auto const start_index = getSlotIndex(counter);
+        auto const first_segment
+            = m_mirrored_mapping ? count : std::min(count, m_queue_length - start_index);
+        std::memcpy(
+            getBufferSlot(start_index), elements, first_segment * m_element_size_in_bytes);
+        if (first_segment < count) {
+            std::memcpy(getBufferSlot(0), elements + (first_segment * m_element_size_in_bytes),
+                (count - first_segment) * m_element_size_in_bytes);
+        }
+    }
+    auto copyFromSlots(uint64_t counter, uint8_t* const elements, uint64_t count) -> void
+    {
+        auto const start_index = getSlotIndex(counter);
+        auto const first_segment
+            = m_mirrored_mapping ? count : std::min(count, m_queue_length - start_index);
+        std::memcpy(
+            elements, getBufferSlot(start_index), first_segment * m_element_size_in_bytes);
+        if (first_segment < count) {
+            std::memcpy(elements + (first_segment * m_element_size_in_bytes), getBufferSlot(0),
+                (count - first_segment) * m_element_size_in_bytes);
+        }
+    }
+    // The ring object lives in the shared buffer it manages, the slots are located relative to
+    // it so that endpoints that map the buffer at different addresses agree on them
+    auto setRingBuffer(uint8_t* buffer) -> void
+    {
+        m_ring_buffer_offset
+            = reinterpret_cast<std::uintptr_t>(buffer) - reinterpret_cast<std::uintptr_t>(this);
+    }
+    [[nodiscard]] auto getRingBuffer() const -> uint8_t*
+    {
+        return reinterpret_cast<uint8_t*>(
+            reinterpret_cast<std::uintptr_t>(this) + m_ring_buffer_offset);
+    }
+    std::uintptr_t m_ring_buffer_offset = 0;
     uint64_t m_element_alignment = 0;
     uint64_t m_element_size_in_bytes = 0;
     uint64_t m_queue_length = 0;
+    uint64_t m_index_mask = 0;
+    bool m_mirrored_mapping = false;
 };
 
 template <typename T>
 concept RingBufferType = std::derived_from<T, RingBufferBase>;
 
+// Bounded queue protected by a single coarse grained lock. MutexType/ConditionVariableType is
+// either the pthread based Mutex/ConditionVariable or FutexMutex/FutexConditionVariable.
+template <typename MutexType, typename ConditionVariableType>
 struct RingBufferLockProtected : public RingBufferBase {
 public:
     [[nodiscard]] auto PushFront(uint8_t const* const element, DurationUs timeout_duration)
@@ -100,6 +190,16 @@ public:
         -> std::expected<uint8_t const* const, PikaError> override;
     [[nodiscard]] virtual auto ReleaseBackElementPtr(uint8_t const* const element)
         -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFrontBatch(uint8_t const* const elements, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override;
+    [[nodiscard]] auto PopBackBatch(uint8_t* const elements, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError> override;
+    [[nodiscard]] auto GetWakeupStatistics() const -> WakeupStatistics
+    {
+        return WakeupStatistics { .signals_sent = m_signals_sent.load(std::memory_order_relaxed),
+            .signals_skipped = m_signals_skipped.load(std::memory_order_relaxed) };
+    }
 
 protected:
     [[nodiscard]] static auto initialize(RingBufferLockProtected& ring_buffer_object,
@@ -107,15 +207,39 @@ protected:
         uint64_t number_of_elements, bool is_inter_process) -> std::expected<void, PikaError>;
 
 private:
-    Mutex m_mutex {}; // Coarse grained lock protecting all accesses to the buffer
-    ConditionVariable m_not_empty_condition_variable {};
-    ConditionVariable m_not_full_condition_variable {};
-    uint64_t m_write_index = 0;
-    uint64_t m_read_index = 0;
+    enum class Wakeup : uint8_t { None, One, All };
+    [[nodiscard]] auto lock(Deadline const& deadline) -> std::expected<void, PikaError>;
+    // Called with the lock held, block until the ring has a free slot/min_count elements. On
+    // timeout the lock is still held and the ring is left untouched.
+    [[nodiscard]] auto waitForFreeSlot(Deadline const& deadline) -> std::expected<void, PikaError>;
+    [[nodiscard]] auto waitForElements(uint64_t min_count, Deadline const& deadline)
+        -> std::expected<void, PikaError>;
+    // Called with the lock held after the ring changed, also counts the decision. Nobody is woken
+    // if every waiter has already been sent a wakeup it has not consumed yet.
+    [[nodiscard]] auto getWakeup(uint64_t waiting, uint64_t& wakeups_pending, bool wake_all)
+        -> Wakeup;
+    // Called after unlocking
+    auto notify(ConditionVariableType& condition_variable, Wakeup wakeup) -> void;
+    MutexType m_mutex {}; // Coarse grained lock protecting all accesses to the buffer
+    ConditionVariableType m_not_empty_condition_variable {};
+    ConditionVariableType m_not_full_condition_variable {};
+    uint64_t m_producers_waiting = 0;
+    uint64_t m_consumers_waiting = 0;
+    uint64_t m_batch_consumers_waiting = 0; // Consumers waiting for more than one element
+    // Wakeups sent to waiters that have not woken up yet
+    uint64_t m_producer_wakeups_pending = 0;
+    uint64_t m_consumer_wakeups_pending = 0;
+    // Only written by getWakeup under the mutex, atomic so that the statistics can be read
+    // without it
+    std::atomic_uint64_t m_signals_sent = 0;
+    std::atomic_uint64_t m_signals_skipped = 0;
+    uint64_t m_write_index = 0; // Free running
+    uint64_t m_read_index = 0; // Free running
     uint64_t m_count = 0;
 };
 
-struct RingBufferInterProcessLockProtected : public RingBufferLockProtected {
+struct RingBufferInterProcessLockProtected
+    : public RingBufferLockProtected<Mutex, ConditionVariable> {
     [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
         uint64_t element_alignment, uint64_t number_of_elements)
         -> std::expected<void, PikaError> override
@@ -125,7 +249,8 @@ struct RingBufferInterProcessLockProtected : public RingBufferLockProtected {
     }
 };
 
-struct RingBufferInterThreadLockProtected : public RingBufferLockProtected {
+struct RingBufferInterThreadLockProtected
+    : public RingBufferLockProtected<Mutex, ConditionVariable> {
     [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
         uint64_t element_alignment, uint64_t number_of_elements)
         -> std::expected<void, PikaError> override
@@ -135,6 +260,93 @@ struct RingBufferInterThreadLockProtected : public RingBufferLockProtected {
     }
 };
 
+// Futex words work the same within a process and across processes, a single type serves both
+// channel types
+struct RingBufferFutexLockProtected
+    : public RingBufferLockProtected<FutexMutex, FutexConditionVariable> {
+    [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
+        uint64_t element_alignment, uint64_t number_of_elements)
+        -> std::expected<void, PikaError> override
+    {
+        return RingBufferLockProtected::initialize(
+            *this, buffer, element_size, element_alignment, number_of_elements, true);
+    }
+};
+
+// Bounded queue with separate producer and consumer locks: producers only contend with
+// producers and consumers only with consumers. The occupancy is maintained atomically and a side
+// only takes the other side's lock to signal the empty->not empty or full->not full transitions;
+// waiters wake each other in a cascade while there is work left.
+struct RingBufferTwoLock : public RingBufferBase {
+public:
+    [[nodiscard]] auto PushFront(uint8_t const* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PopBack(uint8_t* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetFrontElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError> override;
+    [[nodiscard]] auto ReleaseFrontElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetBackElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t const* const, PikaError> override;
+    [[nodiscard]] auto ReleaseBackElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFrontBatch(uint8_t const* const elements, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override;
+    [[nodiscard]] auto PopBackBatch(uint8_t* const elements, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError> override;
+
+protected:
+    [[nodiscard]] static auto initialize(RingBufferTwoLock& ring_buffer_object, uint8_t* buffer,
+        uint64_t element_size, uint64_t element_alignment, uint64_t number_of_elements,
+        bool is_inter_process) -> std::expected<void, PikaError>;
+
+private:
+    // Unlocks the mutex a timed out wait still holds and builds the Timeout error
+    [[nodiscard]] static auto timeoutError(Mutex& locked_mutex, ErrorMessage error_message)
+        -> PikaError;
+    // Called with the producer(consumer) lock held once count elements were written(read).
+    // Updates the occupancy, wakes the next waiter on the same side if there is room(elements)
+    // left and returns the occupancy before the update.
+    [[nodiscard]] auto publish(uint64_t count) -> uint64_t;
+    [[nodiscard]] auto consume(uint64_t count) -> uint64_t;
+    // Called without holding any lock, wakes the other side if it may be waiting
+    auto signalNotEmpty(uint64_t previous_count, uint64_t count) -> void;
+    auto signalNotFull(uint64_t previous_count, uint64_t count) -> void;
+
+    // Producer side
+    alignas(CACHE_LINE_SIZE) Mutex m_producer_mutex {};
+    ConditionVariable m_not_full_condition_variable {};
+    uint64_t m_write_index = 0; // Free running
+    // Consumer side
+    alignas(CACHE_LINE_SIZE) Mutex m_consumer_mutex {};
+    ConditionVariable m_not_empty_condition_variable {};
+    uint64_t m_read_index = 0; // Free running
+    std::atomic_uint64_t m_batch_consumers_waiting = 0; // Consumers waiting for several elements
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t m_count = 0;
+};
+
+struct RingBufferInterProcessTwoLock : public RingBufferTwoLock {
+    [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
+        uint64_t element_alignment, uint64_t number_of_elements)
+        -> std::expected<void, PikaError> override
+    {
+        return RingBufferTwoLock::initialize(
+            *this, buffer, element_size, element_alignment, number_of_elements, true);
+    }
+};
+
+struct RingBufferInterThreadTwoLock : public RingBufferTwoLock {
+    [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
+        uint64_t element_alignment, uint64_t number_of_elements)
+        -> std::expected<void, PikaError> override
+    {
+        return RingBufferTwoLock::initialize(
+            *this, buffer, element_size, element_alignment, number_of_elements, false);
+    }
+};
+
 struct RingBufferLockFree : public RingBufferBase {
     [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
         uint64_t element_alignment, uint64_t number_of_elements)
@@ -144,48 +356,427 @@ struct RingBufferLockFree : public RingBufferBase {
     [[nodiscard]] auto PopBack(uint8_t* const element, DurationUs timeout_duration)
         -> std::expected<void, PikaError> override;
     [[nodiscard]] auto GetFrontElementPtr(DurationUs timeout_duration)
-        -> std::expected<uint8_t* const, PikaError> override
+        -> std::expected<uint8_t* const, PikaError> override;
+    [[nodiscard]] auto ReleaseFrontElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] virtual auto GetBackElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t const* const, PikaError> override;
+    [[nodiscard]] virtual auto ReleaseBackElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFrontBatch(uint8_t const* const elements, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override;
+    [[nodiscard]] auto PopBackBatch(uint8_t* const elements, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError> override;
+    // Selects how the producer and consumer wait on a full/empty ring
+    auto SetWaitStrategy(pika::WaitStrategy const& wait_strategy) -> void;
+    [[nodiscard]] auto GetWaitStrategy() const -> pika::WaitStrategy const&
     {
-        static_cast<void>(timeout_duration);
-        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
-            .error_message = "Zero-copy API not supported" } };
+        return m_wait_strategy;
     }
+
+private:
+    // Waits until at least one slot at the tail is free(returns the tail) or until at least
+    // min_count slots starting at the head hold elements(returns the head)
+    [[nodiscard]] auto waitForFreeSlot(DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError>;
+    [[nodiscard]] auto waitForElement(DurationUs timeout_duration, uint64_t min_count = 1)
+        -> std::expected<uint64_t, PikaError>;
+    // m_head and m_tail are free running counters, the ring is full when they are
+    // m_queue_length apart and empty when they are equal
+    // Producer owned; m_cached_head is the producer's last observed value of m_head
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t m_tail = 0;
+    uint64_t m_cached_head = 0;
+    // Consumer owned; m_cached_tail is the consumer's last observed value of m_tail
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t m_head = 0;
+    uint64_t m_cached_tail = 0;
+    // Read-only after initialization, kept apart from the indices
+    alignas(CACHE_LINE_SIZE) pika::WaitStrategy m_wait_strategy {};
+    // Number of producers/consumers parked on m_head/m_tail in WaitStrategyType::SpinPark mode.
+    // Only written when a side parks, so the publishing side reads them from a clean cache line.
+    alignas(CACHE_LINE_SIZE) std::atomic_uint32_t m_parked_producers = 0;
+    std::atomic_uint32_t m_parked_consumers = 0;
+};
+
+// Bounded multi-producer multi-consumer lock-free queue. Every cell carries a sequence counter
+// that tells producers and consumers whose turn it is to access the cell, so producers only
+// contend on the enqueue position and consumers only on the dequeue position.
+struct RingBufferLockFreeMPMC : public RingBufferBase {
+    [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
+        uint64_t element_alignment, uint64_t number_of_elements)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFront(uint8_t const* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PopBack(uint8_t* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetFrontElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError> override;
     [[nodiscard]] auto ReleaseFrontElementPtr(uint8_t const* const element)
-        -> std::expected<void, PikaError> override
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetBackElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t const* const, PikaError> override;
+    [[nodiscard]] auto ReleaseBackElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFrontBatch(uint8_t const* const elements, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override;
+    [[nodiscard]] auto PopBackBatch(uint8_t* const elements, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError> override;
+
+private:
+    [[nodiscard]] auto getCellSequence(uint64_t position) -> std::atomic_uint64_t&
     {
-        static_cast<void>(element);
-        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
-            .error_message = "Zero-copy API not supported" } };
+        return *reinterpret_cast<std::atomic_uint64_t*>(
+            getRingBuffer() + (getSlotIndex(position) * m_cell_stride));
     }
-    [[nodiscard]] virtual auto GetBackElementPtr(DurationUs timeout_duration)
-        -> std::expected<uint8_t const* const, PikaError> override
+    [[nodiscard]] auto getCellElement(uint64_t position) -> uint8_t*
     {
-        static_cast<void>(timeout_duration);
-        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
-            .error_message = "Zero-copy API not supported" } };
+        return getRingBuffer() + (getSlotIndex(position) * m_cell_stride) + m_element_offset;
     }
-    [[nodiscard]] virtual auto ReleaseBackElementPtr(uint8_t const* const element)
-        -> std::expected<void, PikaError> override
+    [[nodiscard]] auto getCellSequenceFromElement(uint8_t const* const element)
+        -> std::expected<std::atomic_uint64_t*, PikaError>;
+    struct Reservation {
+        uint64_t position = 0; // First claimed position
+        uint64_t count = 0; // Number of consecutive claimed positions
+    };
+    // Claims up to max_count consecutive positions to write to/read from with a single CAS. The
+    // claimed cells are exclusively owned by the caller until their sequence counters are
+    // advanced. reserveBack only claims once at least min_count positions have been published.
+    [[nodiscard]] auto reserveFront(DurationUs timeout_duration, uint64_t max_count = 1)
+        -> std::expected<Reservation, PikaError>;
+    [[nodiscard]] auto reserveBack(DurationUs timeout_duration, uint64_t max_count = 1,
+        uint64_t min_count = 1) -> std::expected<Reservation, PikaError>;
+
+    uint64_t m_cell_stride = 0;
+    uint64_t m_element_offset = 0;
+    // Contended by producers only
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t m_enqueue_position = 0;
+    // Contended by consumers only
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t m_dequeue_position = 0;
+};
+
+// Single producer, many consumer broadcast queue. Every element is written once and read by
+// every registered consumer, each of which advances its own cursor. The producer is gated by the
+// slowest registered consumer. The consumer side is only reachable through a cursor obtained
+// from RegisterConsumer; the cursor-less RingBufferBase consumer functions return an error.
+struct RingBufferBroadcast : public RingBufferBase {
+    static constexpr uint64_t MAX_CONSUMERS = 16;
+    [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
+        uint64_t element_alignment, uint64_t number_of_elements)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFront(uint8_t const* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PopBack(uint8_t* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetFrontElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError> override;
+    [[nodiscard]] auto ReleaseFrontElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetBackElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t const* const, PikaError> override;
+    [[nodiscard]] auto ReleaseBackElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFrontBatch(uint8_t const* const elements, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override;
+    [[nodiscard]] auto PopBackBatch(uint8_t* const elements, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError> override;
+    //*****************************************************************************************//
+    // Claims a cursor that starts at the next element to be published
+    [[nodiscard]] auto RegisterConsumer() -> std::expected<uint64_t, PikaError>;
+    auto UnregisterConsumer(uint64_t cursor_id) -> void;
+    [[nodiscard]] auto PopBack(uint64_t cursor_id, uint8_t* const element,
+        DurationUs timeout_duration) -> std::expected<void, PikaError>;
+    [[nodiscard]] auto GetBackElementPtr(uint64_t cursor_id, DurationUs timeout_duration)
+        -> std::expected<uint8_t const* const, PikaError>;
+    [[nodiscard]] auto ReleaseBackElementPtr(uint64_t cursor_id, uint8_t const* const element)
+        -> std::expected<void, PikaError>;
+    [[nodiscard]] auto PopBackBatch(uint64_t cursor_id, uint8_t* const elements,
+        uint64_t max_count, uint64_t min_count, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError>;
+
+private:
+    // Waits until at least one slot at the tail is free of every registered cursor(returns the
+    // tail) or until at least min_count elements are ahead of the cursor(returns its position)
+    [[nodiscard]] auto waitForFreeSlot(DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError>;
+    [[nodiscard]] auto waitForElement(uint64_t cursor_id, DurationUs timeout_duration,
+        uint64_t min_count = 1) -> std::expected<uint64_t, PikaError>;
+    // Position of the slowest registered cursor, or current_tail if there is none
+    [[nodiscard]] auto getSlowestCursor(uint64_t current_tail) -> uint64_t;
+
+    struct alignas(CACHE_LINE_SIZE) Cursor {
+        std::atomic_bool registered = false;
+        std::atomic_uint64_t position = 0; // Next element to read, owned by the consumer
+    };
+    // Producer owned; m_cached_slowest_cursor is the producer's last observed slowest cursor
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t m_tail = 0;
+    uint64_t m_cached_slowest_cursor = 0;
+    Cursor m_cursors[MAX_CONSUMERS];
+};
+
+// Single producer single consumer ring of variable length records. The ring is made of
+// queue_length bytes; every record starts with an 8-byte length word and is padded so that the
+// next record is 8-byte aligned again. A record that would cross the end of the ring is
+// preceded by a padding record covering the tail end of the ring, so that readers always see
+// contiguous records. With a mirrored mapping records simply run over the end of the ring and
+// no padding is needed. The element based RingBufferBase functions return an error.
+struct RingBufferBytes : public RingBufferBase {
+    static constexpr uint64_t RECORD_ALIGNMENT = sizeof(uint64_t);
+    [[nodiscard]] static constexpr auto GetRecordSize(uint64_t payload_size) -> uint64_t
+    {
+        return ((sizeof(uint64_t) + payload_size + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT)
+            * RECORD_ALIGNMENT;
+    }
+    [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
+        uint64_t element_alignment, uint64_t number_of_elements)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFront(uint8_t const* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PopBack(uint8_t* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetFrontElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError> override;
+    [[nodiscard]] auto ReleaseFrontElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetBackElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t const* const, PikaError> override;
+    [[nodiscard]] auto ReleaseBackElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFrontBatch(uint8_t const* const elements, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override;
+    [[nodiscard]] auto PopBackBatch(uint8_t* const elements, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError> override;
+    //*****************************************************************************************//
+    // Reserves a contiguous payload of size bytes. The record is published by CommitBytes.
+    [[nodiscard]] auto ReserveBytes(uint64_t size, DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError>;
+    [[nodiscard]] auto CommitBytes(uint8_t const* const payload) -> std::expected<void, PikaError>;
+    [[nodiscard]] auto PushBytes(uint8_t const* const source, uint64_t size,
+        DurationUs timeout_duration) -> std::expected<void, PikaError>;
+    // Pops the next record into destination and returns its size. A record larger than
+    // destination_size is left in the ring.
+    [[nodiscard]] auto PopBytes(uint8_t* const destination, uint64_t destination_size,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>;
+    // Zero-copy access to the next record, which stays in the ring until ReleaseBytes
+    [[nodiscard]] auto PeekBytes(DurationUs timeout_duration)
+        -> std::expected<std::span<uint8_t const>, PikaError>;
+    [[nodiscard]] auto ReleaseBytes(uint8_t const* const payload)
+        -> std::expected<void, PikaError>;
+    auto SetWaitStrategy(pika::WaitStrategy const& wait_strategy) -> void;
+    [[nodiscard]] auto GetWaitStrategy() const -> pika::WaitStrategy const&
     {
+        return m_wait_strategy;
+    }
 
-        static_cast<void>(element);
-        return std::unexpected { PikaError { .error_type = PikaErrorType::RingBufferError,
-            .error_message = "Zero-copy API not supported" } };
+private:
+    static constexpr uint64_t PADDING_RECORD_FLAG = uint64_t { 1 } << 63;
+    // Waits until size bytes starting at the tail are free(returns the tail) or until the ring
+    // holds a record(returns the head)
+    [[nodiscard]] auto waitForFreeBytes(uint64_t size, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError>;
+    [[nodiscard]] auto waitForRecord(DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError>;
+    // Waits for the next record that is not padding, returns its position
+    [[nodiscard]] auto waitForPayloadRecord(DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError>;
+    [[nodiscard]] auto getLengthWord(uint64_t counter) -> uint64_t*
+    {
+        return reinterpret_cast<uint64_t*>(getBufferSlot(getSlotIndex(counter)));
     }
+    // m_head and m_tail are free running byte counters
+    // Producer owned; m_reserved_size is the payload size of the outstanding ReserveBytes call
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t m_tail = 0;
+    uint64_t m_cached_head = 0;
+    uint64_t m_reserved_size = 0;
+    bool m_reserved = false;
+    // Consumer owned
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t m_head = 0;
+    uint64_t m_cached_tail = 0;
+    alignas(CACHE_LINE_SIZE) pika::WaitStrategy m_wait_strategy {};
+    alignas(CACHE_LINE_SIZE) std::atomic_uint32_t m_parked_producers = 0;
+    std::atomic_uint32_t m_parked_consumers = 0;
+};
+
+// Conflating single producer, many consumer channel holding only the latest value. Values are
+// written round-robin into a small set of seqlock protected cells so that readers rarely race
+// the producer, and published by bumping m_latest. The producer never waits; readers copy the
+// latest value and retry when the copy was torn by a concurrent write. Readers keep track of the
+// last sequence number they have seen, so the cursor-less RingBufferBase consumer functions
+// return an error.
+struct RingBufferConflating : public RingBufferBase {
+    [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
+        uint64_t element_alignment, uint64_t number_of_elements)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFront(uint8_t const* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PopBack(uint8_t* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetFrontElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError> override;
+    [[nodiscard]] auto ReleaseFrontElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetBackElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t const* const, PikaError> override;
+    [[nodiscard]] auto ReleaseBackElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    // Only the last of the elements is published, the older ones are conflated away
+    [[nodiscard]] auto PushFrontBatch(uint8_t const* const elements, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override;
+    [[nodiscard]] auto PopBackBatch(uint8_t* const elements, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError> override;
+    //*****************************************************************************************//
+    // Waits for a value newer than last_sequence_number and copies the latest one. Returns its
+    // sequence number; values are numbered from 1 in publish order.
+    [[nodiscard]] auto ReadLatest(uint8_t* const element, uint64_t last_sequence_number,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>;
 
 private:
-    [[nodiscard]] auto getBufferSlot_(uint64_t index) -> uint8_t*
+    [[nodiscard]] auto getCellSequence(uint64_t sequence_number) -> std::atomic_uint64_t&
     {
-        PIKA_ASSERT(index < m_internal_queue_length);
-        return m_ring_buffer + (index * m_element_size_in_bytes);
+        return *reinterpret_cast<std::atomic_uint64_t*>(
+            getRingBuffer() + (getSlotIndex(sequence_number - 1) * m_cell_stride));
     }
-    auto incrementByOne(uint64_t index) const -> uint64_t
+    [[nodiscard]] auto getCellElement(uint64_t sequence_number) -> uint8_t*
     {
-        PIKA_ASSERT(index <= m_internal_queue_length);
-        return (index + 1) % (m_internal_queue_length);
+        return getRingBuffer() + (getSlotIndex(sequence_number - 1) * m_cell_stride)
+            + m_element_offset;
     }
-    std::atomic_uint64_t m_head = 0;
-    std::atomic_uint64_t m_tail = 0;
-    uint64_t m_internal_queue_length = 0;
+    // The cell's seqlock counter once the value with the given sequence number is written; it is
+    // odd while a write to the cell is in progress
+    [[nodiscard]] auto getStableCellSequence(uint64_t sequence_number) const -> uint64_t
+    {
+        return 2 * (((sequence_number - 1) / m_queue_length) + 1);
+    }
+    // Marks the next cell as being written and returns the sequence number it will publish
+    [[nodiscard]] auto beginWrite() -> uint64_t;
+    auto endWrite(uint64_t sequence_number) -> void;
+
+    uint64_t m_cell_stride = 0;
+    uint64_t m_element_offset = 0;
+    // Producer owned, read by every consumer
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t m_latest = 0;
+    bool m_write_in_progress = false;
 };
-#endif
\ No newline at end of file
+
+// Triple buffer for a single producer and a single consumer that only care about the latest
+// element. The producer owns the back buffer and the consumer the front buffer; the third one
+// sits in the middle. Publishing swaps the back and middle buffers and flags the middle one as
+// fresh, acquiring swaps the front and middle buffers if the middle one is fresh. Neither side
+// ever waits for the other, the consumer only waits for a fresh element to be published.
+struct RingBufferTripleBuffer : public RingBufferBase {
+    static constexpr uint64_t NUMBER_OF_BUFFERS = 3;
+    [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
+        uint64_t element_alignment, uint64_t number_of_elements)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFront(uint8_t const* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PopBack(uint8_t* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetFrontElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError> override;
+    [[nodiscard]] auto ReleaseFrontElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    // The returned buffer stays valid until the next GetBackElementPtr/PopBack call
+    [[nodiscard]] auto GetBackElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t const* const, PikaError> override;
+    [[nodiscard]] auto ReleaseBackElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    // Only the last of the elements is published, the older ones are dropped
+    [[nodiscard]] auto PushFrontBatch(uint8_t const* const elements, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override;
+    [[nodiscard]] auto PopBackBatch(uint8_t* const elements, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError> override;
+
+private:
+    static constexpr uint8_t INDEX_MASK = 0b011;
+    static constexpr uint8_t FRESH_FLAG = 0b100;
+    auto publishBack() -> void;
+    // Waits until a fresh element is published and makes it the front buffer
+    [[nodiscard]] auto acquireFront(DurationUs timeout_duration)
+        -> std::expected<uint8_t*, PikaError>;
+
+    // Index of the middle buffer and whether it holds an element the consumer has not seen
+    alignas(CACHE_LINE_SIZE) std::atomic_uint8_t m_middle = 1;
+    // Producer owned
+    alignas(CACHE_LINE_SIZE) uint8_t m_back = 0;
+    // Consumer owned
+    alignas(CACHE_LINE_SIZE) uint8_t m_front = 2;
+};
+
+// Multi producer single consumer channel made of one single producer single consumer lane per
+// producer. Each lane has queue_length slots, the slots of lane i follow the slots of lane i-1.
+// Producers claim a lane when they are created and only ever touch the indices of their own lane,
+// so they never contend with each other and pushing needs no read-modify-write. The single
+// consumer drains the lanes round-robin. The lane-less producer functions return an error.
+struct RingBufferProducerLanes : public RingBufferBase {
+    static constexpr uint64_t MAX_PRODUCERS = 16;
+    [[nodiscard]] auto Initialize(uint8_t* buffer, uint64_t element_size,
+        uint64_t element_alignment, uint64_t number_of_elements)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFront(uint8_t const* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PopBack(uint8_t* const element, DurationUs timeout_duration)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetFrontElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError> override;
+    [[nodiscard]] auto ReleaseFrontElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto GetBackElementPtr(DurationUs timeout_duration)
+        -> std::expected<uint8_t const* const, PikaError> override;
+    [[nodiscard]] auto ReleaseBackElementPtr(uint8_t const* const element)
+        -> std::expected<void, PikaError> override;
+    [[nodiscard]] auto PushFrontBatch(uint8_t const* const elements, uint64_t count,
+        DurationUs timeout_duration) -> std::expected<uint64_t, PikaError> override;
+    [[nodiscard]] auto PopBackBatch(uint8_t* const elements, uint64_t max_count,
+        uint64_t min_count, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError> override;
+    //*****************************************************************************************//
+    // Claims a lane for a new producer. Elements left behind in the lane by its previous owner
+    // are still delivered to the consumer.
+    [[nodiscard]] auto RegisterProducer() -> std::expected<uint64_t, PikaError>;
+    auto UnregisterProducer(uint64_t lane_id) -> void;
+    [[nodiscard]] auto PushFront(uint64_t lane_id, uint8_t const* const element,
+        DurationUs timeout_duration) -> std::expected<void, PikaError>;
+    [[nodiscard]] auto GetFrontElementPtr(uint64_t lane_id, DurationUs timeout_duration)
+        -> std::expected<uint8_t* const, PikaError>;
+    [[nodiscard]] auto ReleaseFrontElementPtr(uint64_t lane_id, uint8_t const* const element)
+        -> std::expected<void, PikaError>;
+    [[nodiscard]] auto PushFrontBatch(uint64_t lane_id, uint8_t const* const elements,
+        uint64_t count, DurationUs timeout_duration) -> std::expected<uint64_t, PikaError>;
+
+private:
+    [[nodiscard]] auto getLaneSlot(uint64_t lane_id, uint64_t counter) -> uint8_t*
+    {
+        return getBufferSlot(getSlotIndex(counter)) + (lane_id * m_lane_size_in_bytes);
+    }
+    // Waits until the lane has at least one free slot, returns its tail
+    [[nodiscard]] auto waitForFreeSlot(uint64_t lane_id, DurationUs timeout_duration)
+        -> std::expected<uint64_t, PikaError>;
+    // Waits until the lanes hold at least min_count elements in total, returns the first lane in
+    // round-robin order that is not empty
+    [[nodiscard]] auto waitForElement(DurationUs timeout_duration, uint64_t min_count = 1)
+        -> std::expected<uint64_t, PikaError>;
+    auto popFromLane(uint64_t lane_id, uint8_t* const elements, uint64_t count) -> void;
+
+    struct Lane {
+        // Producer owned; cached_head is the producer's last observed head
+        alignas(CACHE_LINE_SIZE) std::atomic_bool registered = false;
+        std::atomic_uint64_t tail = 0;
+        uint64_t cached_head = 0;
+        // Consumer owned
+        alignas(CACHE_LINE_SIZE) std::atomic_uint64_t head = 0;
+    };
+    uint64_t m_lane_size_in_bytes = 0;
+    // One past the highest lane ever claimed, the consumer only scans the lanes below it
+    alignas(CACHE_LINE_SIZE) std::atomic_uint64_t m_lane_count = 0;
+    // Consumer owned; m_next_lane is where the next round-robin scan starts
+    alignas(CACHE_LINE_SIZE) uint64_t m_next_lane = 0;
+    uint64_t m_held_lane = 0; // Lane of the element handed out by GetBackElementPtr
+    Lane m_lanes[MAX_PRODUCERS];
+};
+
+#endif
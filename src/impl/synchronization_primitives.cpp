@@ -25,75 +25,195 @@
 #include "error.hpp"
 #include "fmt/core.h"
 
+#include <algorithm>
 #include <bits/types/struct_timespec.h>
 #include <cerrno>
 #include <cstdio>
 #include <fcntl.h>
+#include <linux/futex.h>
+#include <optional>
 #include <pthread.h>
-#include <semaphore.h>
+#include <sys/syscall.h>
+#include <thread>
 #include <unistd.h>
 
-auto Semaphore::New(std::string const& semaphore_name, int32_t initial_value)
-    -> std::expected<Semaphore, PikaError>
+auto Futex::Wait(uint32_t const* futex_word, uint32_t expected_value, DurationUs timeout_duration)
+    -> bool
 {
-    if (semaphore_name.at(0) != '/') {
-        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
-            .error_message = "Semaphore::Initialize: Semaphore name must begin with a \"/\"" });
+    timespec relative_timeout {};
+    timespec* relative_timeout_ptr = nullptr;
+    if (timeout_duration != pika::INFINITE_TIMEOUT) {
+        relative_timeout.tv_sec
+            = static_cast<decltype(timespec::tv_sec)>(timeout_duration / 1000000);
+        relative_timeout.tv_nsec
+            = static_cast<decltype(timespec::tv_nsec)>((timeout_duration % 1000000) * 1000);
+        relative_timeout_ptr = &relative_timeout;
     }
-    auto sem_ptr = sem_open(semaphore_name.c_str(), O_CREAT, S_IRUSR | S_IWUSR, initial_value);
-    if (sem_ptr == SEM_FAILED) {
+    // FUTEX_WAIT(without FUTEX_PRIVATE_FLAG) works on memory shared across processes
+    auto const return_code = syscall(SYS_futex, futex_word, FUTEX_WAIT, expected_value,
+        relative_timeout_ptr, nullptr, 0);
+    if (return_code == -1) {
+        auto const error = errno;
+        errno = 0;
+        // EAGAIN: the word no longer held expected_value, EINTR: interrupted by a signal
+        return error != ETIMEDOUT;
+    }
+    return true;
+}
+
+auto Futex::Wake(uint32_t const* futex_word, int32_t number_of_waiters) -> void
+{
+    auto const return_code
+        = syscall(SYS_futex, futex_word, FUTEX_WAKE, number_of_waiters, nullptr, nullptr, 0);
+    if (return_code == -1) {
         auto error_message = strerror(errno);
         errno = 0;
-        return std::unexpected(PikaError { .error_type = PikaErrorType::SharedBufferError,
-            .error_message = fmt::format("sem_open failed with error:{}", error_message) });
+        fmt::println(stderr, "Futex::Wake failed with error {}", error_message);
     }
-    Semaphore sem;
-    sem.m_sem = sem_ptr;
-    sem.m_sem_name = semaphore_name;
-    return sem;
 }
 
-Semaphore::~Semaphore()
+auto Backoff::Pause(uint64_t observed_value, DurationUs remaining_timeout) -> void
 {
-    if (m_sem != nullptr) {
-        auto ret = sem_close(m_sem);
-        if (ret != 0) {
-            auto error_message = strerror(errno);
-            errno = 0;
-            fmt::println(stderr, "Semaphore::~Semaphore sem_unlink({}) failed with error {}",
-                m_sem_name, error_message);
-            return;
+    switch (m_strategy.type) {
+    case pika::WaitStrategyType::BusySpin:
+        return;
+    case pika::WaitStrategyType::SpinPause:
+        CpuRelax();
+        return;
+    case pika::WaitStrategyType::SpinYield:
+        if (m_iteration < m_strategy.spin_budget) {
+            ++m_iteration;
+            CpuRelax();
+        } else {
+            std::this_thread::yield();
         }
-        m_sem_name.clear();
-        m_sem = nullptr;
+        return;
+    case pika::WaitStrategyType::SpinPark:
+        if (m_iteration < m_strategy.spin_budget) {
+            ++m_iteration;
+            CpuRelax();
+        } else {
+            m_parked_count.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            // The kernel re-checks the futex word, a wake racing with this call is not lost
+            static_cast<void>(Futex::Wait(Futex::GetLowWord(m_watched_counter),
+                static_cast<uint32_t>(observed_value),
+                std::min(m_strategy.max_park_duration, remaining_timeout)));
+            m_parked_count.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return;
     }
 }
 
-Semaphore::Semaphore(Semaphore&& other)
+auto FutexMutex::Initialize(bool) -> std::expected<void, PikaError>
 {
-    m_sem = other.m_sem;
-    m_sem_name = std::move(other.m_sem_name);
-    other.m_sem = nullptr;
+    m_lock_word.store(UNLOCKED);
+    m_spin_estimate.store(0);
+    return {};
 }
 
-auto Semaphore::Wait() -> void
+auto FutexMutex::lockContended(Deadline const& deadline) -> bool
 {
-    PIKA_ASSERT(m_sem != nullptr);
-    if (sem_wait(m_sem) != 0) {
-        auto error_message = strerror(errno);
-        errno = 0;
-        fmt::println(stderr, "Semaphore::Wait sem_wait failed with error {}", error_message);
+    // Spin for up to twice the running estimate, like glibc's adaptive mutexes. The estimate
+    // converges towards the number of spins that were actually needed and decays when spinning
+    // did not pay off. Spinning never pays off without a second CPU to run the owner.
+    static auto const spinning_enabled = std::thread::hardware_concurrency() > 1;
+    auto const spin_estimate = m_spin_estimate.load(std::memory_order_relaxed);
+    auto const max_spin_count
+        = spinning_enabled ? std::min(MAX_SPIN_COUNT, (spin_estimate * 2) + 10) : 0;
+    for (int32_t spin_count = 0; spin_count < max_spin_count; ++spin_count) {
+        CpuRelax();
+        if ((m_lock_word.load(std::memory_order_relaxed) & LOCKED) == 0 && TryLock()) {
+            m_spin_estimate.store(spin_estimate + ((spin_count - spin_estimate) / 8),
+                std::memory_order_relaxed);
+            return true;
+        }
+    }
+    m_spin_estimate.store(spin_estimate - (spin_estimate / 8), std::memory_order_relaxed);
+
+    // Park. Registering as a waiter makes Unlock wake us, taking the lock deregisters again.
+    auto lock_word = m_lock_word.fetch_add(WAITER, std::memory_order_relaxed) + WAITER;
+    while (true) {
+        if ((lock_word & LOCKED) == 0) {
+            if (m_lock_word.compare_exchange_weak(lock_word, (lock_word - WAITER) | LOCKED,
+                    std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+            continue;
+        }
+        auto const remaining_timeout = deadline.GetRemainingDuration();
+        if (remaining_timeout == 0) {
+            // The wakeup meant for us may have been consumed, pass it on if the lock is free
+            lock_word = m_lock_word.fetch_sub(WAITER, std::memory_order_relaxed) - WAITER;
+            if ((lock_word & LOCKED) == 0 && lock_word >= WAITER) {
+                Futex::Wake(getLockWord(), 1);
+            }
+            return false;
+        }
+        // The kernel re-checks the whole word, an Unlock or a new waiter in between is not lost
+        static_cast<void>(Futex::Wait(getLockWord(), lock_word, remaining_timeout));
+        lock_word = m_lock_word.load(std::memory_order_relaxed);
     }
 }
 
-auto Semaphore::Post() -> void
+auto FutexConditionVariable::Initialize(bool) -> std::expected<void, PikaError>
 {
-    PIKA_ASSERT(m_sem != nullptr);
-    if (sem_post(m_sem) != 0) {
-        auto error_message = strerror(errno);
-        errno = 0;
-        fmt::println(stderr, "Semaphore::Post sem_post failed with error {}", error_message);
+    static_cast<void>(m_internal_mutex.Initialize());
+    m_sequence.store(0);
+    m_total_count.store(0);
+    m_wakeup_count.store(0);
+    m_woken_count.store(0);
+    return {};
+}
+
+auto FutexConditionVariable::wait(FutexMutex& locked_mutex, Deadline const& deadline) -> bool
+{
+    static_cast<void>(m_internal_mutex.Lock());
+    m_total_count.fetch_add(1, std::memory_order_relaxed);
+    static_cast<void>(locked_mutex.Unlock());
+    auto const wakeup_count = m_wakeup_count.load(std::memory_order_relaxed);
+    auto woken = true;
+    while (true) {
+        auto const sequence = m_sequence.load(std::memory_order_relaxed);
+        static_cast<void>(m_internal_mutex.Unlock());
+        // The kernel re-checks the sequence, a wakeup granted in between is not lost
+        auto const timed_out
+            = not Futex::Wait(getSequenceWord(), sequence, deadline.GetRemainingDuration());
+        static_cast<void>(m_internal_mutex.Lock());
+        auto const current_wakeup_count = m_wakeup_count.load(std::memory_order_relaxed);
+        if (current_wakeup_count != wakeup_count
+            && m_woken_count.load(std::memory_order_relaxed) != current_wakeup_count) {
+            break;
+        }
+        if (timed_out || deadline.HasExpired()) {
+            // Leave as if granted a wakeup, which keeps the counters balanced
+            m_wakeup_count.fetch_add(1, std::memory_order_relaxed);
+            woken = false;
+            break;
+        }
+    }
+    m_woken_count.fetch_add(1, std::memory_order_relaxed);
+    static_cast<void>(m_internal_mutex.Unlock());
+    static_cast<void>(locked_mutex.Lock());
+    return woken;
+}
+
+auto FutexConditionVariable::wake(bool wake_all) -> void
+{
+    // The caller changed the predicate under the user mutex, which every waiter holds while
+    // registering, so a waiter that could miss the change is already counted here
+    if (m_total_count.load() == m_wakeup_count.load()) {
+        return;
+    }
+    static_cast<void>(m_internal_mutex.Lock());
+    auto const total_count = m_total_count.load(std::memory_order_relaxed);
+    auto const wakeup_count = m_wakeup_count.load(std::memory_order_relaxed);
+    if (total_count != wakeup_count) {
+        m_wakeup_count.store(wake_all ? total_count : wakeup_count + 1, std::memory_order_relaxed);
+        m_sequence.fetch_add(1, std::memory_order_relaxed);
+        Futex::Wake(getSequenceWord(), wake_all ? INT32_MAX : 1);
     }
+    static_cast<void>(m_internal_mutex.Unlock());
 }
 
 auto Mutex::Initialize(bool inter_process) -> std::expected<void, PikaError>
@@ -150,20 +270,29 @@ auto Mutex::Lock() -> std::expected<void, PikaError>
 
 auto Mutex::LockTimed(DurationUs duration) -> std::expected<void, PikaError>
 {
-    timespec t { .tv_sec = 0, .tv_nsec = static_cast<decltype(timespec::tv_nsec)>(duration) };
+    return LockUntil(Deadline { duration });
+}
+
+auto Mutex::LockUntil(Deadline const& deadline) -> std::expected<void, PikaError>
+{
+    if (deadline.IsInfinite()) {
+        return Lock();
+    }
     if (not m_initialized) {
         return std::unexpected { PikaError { .error_type = PikaErrorType::SyncPrimitiveError,
             .error_message = "InterProcessMutex::Lock Uninitialized" } };
     }
-    auto return_code = pthread_mutex_timedlock(&m_pthread_mutex, &t);
+    auto const absolute_deadline = deadline.GetMonotonicTimespec();
+    auto return_code
+        = pthread_mutex_clocklock(&m_pthread_mutex, CLOCK_MONOTONIC, &absolute_deadline);
     if (return_code == ETIMEDOUT) {
         return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
-            .error_message = fmt::format("pthread_mutex_timedlock timed out", return_code) } };
+            .error_message = "pthread_mutex_clocklock timed out" } };
     }
     if (return_code != 0) {
         return std::unexpected { PikaError { .error_type = PikaErrorType::SyncPrimitiveError,
             .error_message
-            = fmt::format("pthread_mutex_timedlock failed with return code:{}", return_code) } };
+            = fmt::format("pthread_mutex_clocklock failed with return code:{}", return_code) } };
     }
     return {};
 }
@@ -242,6 +371,13 @@ auto ConditionVariable::Initialize(bool inter_process) -> std::expected<void, Pi
                     "pthread_condattr_setpshared failed with error code:{}", return_code) } };
         }
     }
+    // Timed waits take absolute CLOCK_MONOTONIC deadlines
+    return_code = pthread_condattr_setclock(&cond_attr, CLOCK_MONOTONIC);
+    if (return_code != 0) {
+        return std::unexpected { PikaError { .error_type = PikaErrorType::SyncPrimitiveError,
+            .error_message
+            = fmt::format("pthread_condattr_setclock failed with error code:{}", return_code) } };
+    }
     return_code = pthread_cond_init(&m_pthread_cond, &cond_attr);
     if (return_code != 0) {
         return std::unexpected { PikaError { .error_type = PikaErrorType::SyncPrimitiveError,
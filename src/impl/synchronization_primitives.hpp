@@ -27,27 +27,70 @@
 #include "error.hpp"
 #include "utils.hpp"
 
+#include <atomic>
+#include <bit>
 #include <bits/types/struct_timespec.h>
+#include <cerrno>
+#include <climits>
 #include <cstdint>
 #include <cstdio>
 #include <expected>
 #include <fmt/core.h>
 #include <pthread.h>
-#include <semaphore.h>
 
-struct Semaphore {
-    [[nodiscard]] static auto New(std::string const& semaphore_name, int32_t initial_value)
-        -> std::expected<Semaphore, PikaError>;
-    auto Wait() -> void;
-    auto Post() -> void;
-    Semaphore(Semaphore const&) = delete;
-    Semaphore(Semaphore&&);
-    ~Semaphore();
+// Thin wrapper around the futex syscall. The futex words may live in memory shared across
+// processes.
+struct Futex {
+    // Sleeps while *futex_word == expected_value, until woken or until timeout_duration expires.
+    // Returns false if the timeout expired.
+    static auto Wait(uint32_t const* futex_word, uint32_t expected_value,
+        DurationUs timeout_duration) -> bool;
+    static auto Wake(uint32_t const* futex_word, int32_t number_of_waiters) -> void;
+    // The futex word aliasing the low 32 bits of a 64-bit counter; it changes whenever the
+    // counter is incremented
+    [[nodiscard]] static auto GetLowWord(std::atomic_uint64_t const& counter) -> uint32_t const*
+    {
+        static_assert(sizeof(std::atomic_uint64_t) == sizeof(uint64_t));
+        return reinterpret_cast<uint32_t const*>(&counter)
+            + (std::endian::native == std::endian::big ? 1 : 0);
+    }
+};
+
+// Executes a WaitStrategy while waiting on a shared 64-bit counter to change. Threads parked on
+// the counter are tallied in parked_count so that the side advancing the counter only issues
+// FUTEX_WAKE when somebody is actually asleep(see Backoff::WakeParked).
+struct Backoff {
+    Backoff(pika::WaitStrategy const& strategy, std::atomic_uint64_t const& watched_counter,
+        std::atomic_uint32_t& parked_count)
+        : m_strategy(strategy)
+        , m_watched_counter(watched_counter)
+        , m_parked_count(parked_count)
+    {
+    }
+    // Must be called after every store to a counter that threads may be parked on
+    static auto WakeParked(pika::WaitStrategy const& strategy,
+        std::atomic_uint64_t const& watched_counter, std::atomic_uint32_t const& parked_count)
+        -> void
+    {
+        if (strategy.type != pika::WaitStrategyType::SpinPark) {
+            return;
+        }
+        // Pairs with the fence in Pause: either the parked thread sees the new counter value or
+        // we see its parked_count increment
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (parked_count.load(std::memory_order_relaxed) != 0) {
+            Futex::Wake(Futex::GetLowWord(watched_counter), INT32_MAX);
+        }
+    }
+    // Waits for one step of the strategy. observed_value is the value of the watched counter the
+    // caller last saw; a park is cut short as soon as the counter changes.
+    auto Pause(uint64_t observed_value, DurationUs remaining_timeout) -> void;
 
 private:
-    Semaphore() = default;
-    sem_t* m_sem = nullptr;
-    std::string m_sem_name;
+    pika::WaitStrategy const& m_strategy;
+    std::atomic_uint64_t const& m_watched_counter;
+    std::atomic_uint32_t& m_parked_count;
+    uint64_t m_iteration = 0;
 };
 
 struct Mutex {
@@ -60,6 +103,7 @@ struct Mutex {
     [[nodiscard]] auto Initialize(bool inter_process = false) -> std::expected<void, PikaError>;
     [[nodiscard]] auto Lock() -> std::expected<void, PikaError>;
     [[nodiscard]] auto LockTimed(DurationUs duration) -> std::expected<void, PikaError>;
+    [[nodiscard]] auto LockUntil(Deadline const& deadline) -> std::expected<void, PikaError>;
     [[nodiscard]] auto Unlock() -> std::expected<void, PikaError>;
 
     ~Mutex();
@@ -71,6 +115,128 @@ private:
     pthread_mutex_t m_pthread_mutex {};
 };
 
+// Mutex built directly on a futex word. It holds no pointers and needs no kernel object, so it
+// can be placed anywhere in memory shared across processes(e.g. the ChannelHeader). The lowest bit
+// of the lock word is the lock itself, the bits above it count the parked waiters; unlocking only
+// issues FUTEX_WAKE while that count is non-zero. Contended lockers spin for an adaptively tuned
+// number of iterations before parking.
+struct FutexMutex {
+    FutexMutex() = default;
+    FutexMutex(FutexMutex const&) = delete;
+    FutexMutex(FutexMutex&&) = delete;
+
+    // Resets the lock word, inter_process has no effect
+    [[nodiscard]] auto Initialize(bool inter_process = false) -> std::expected<void, PikaError>;
+    [[nodiscard]] auto TryLock() -> bool
+    {
+        // Parked waiters do not keep the lock from being taken
+        auto lock_word = m_lock_word.load(std::memory_order_relaxed);
+        while ((lock_word & LOCKED) == 0) {
+            if (m_lock_word.compare_exchange_weak(lock_word, lock_word | LOCKED,
+                    std::memory_order_acquire, std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    [[nodiscard]] auto Lock() -> std::expected<void, PikaError>
+    {
+        if (not TryLock()) {
+            static_cast<void>(lockContended(Deadline { pika::INFINITE_TIMEOUT }));
+        }
+        return {};
+    }
+    [[nodiscard]] auto LockTimed(DurationUs duration) -> std::expected<void, PikaError>
+    {
+        return LockUntil(Deadline { duration });
+    }
+    [[nodiscard]] auto LockUntil(Deadline const& deadline) -> std::expected<void, PikaError>
+    {
+        if (not TryLock() && not lockContended(deadline)) {
+            return std::unexpected { PikaError { .error_type = PikaErrorType::Timeout,
+                .error_message = "FutexMutex::LockUntil timed out" } };
+        }
+        return {};
+    }
+    [[nodiscard]] auto Unlock() -> std::expected<void, PikaError>
+    {
+        if (m_lock_word.fetch_sub(LOCKED, std::memory_order_release) >= WAITER) {
+            Futex::Wake(getLockWord(), 1);
+        }
+        return {};
+    }
+
+private:
+    static constexpr uint32_t UNLOCKED = 0;
+    static constexpr uint32_t LOCKED = 1;
+    static constexpr uint32_t WAITER = 2; // One parked waiter in the count above the lock bit
+    static constexpr int32_t MAX_SPIN_COUNT = 128;
+    [[nodiscard]] auto getLockWord() const -> uint32_t const*
+    {
+        static_assert(sizeof(std::atomic_uint32_t) == sizeof(uint32_t));
+        return reinterpret_cast<uint32_t const*>(&m_lock_word);
+    }
+    // Spins then parks until the lock is acquired or the deadline expires
+    [[nodiscard]] auto lockContended(Deadline const& deadline) -> bool;
+
+    std::atomic_uint32_t m_lock_word = UNLOCKED;
+    // Running estimate of the number of spins after which the lock usually becomes free
+    std::atomic_int32_t m_spin_estimate = 0;
+};
+
+// Condition variable for FutexMutex. Waiters sleep on a sequence word that every granted wakeup
+// bumps. A signal only grants a wakeup, and issues FUTEX_WAKE, when some waiter has not been
+// granted one yet, so a burst of signals to a waiter that has not run yet costs one syscall.
+struct FutexConditionVariable {
+    FutexConditionVariable() = default;
+    FutexConditionVariable(FutexConditionVariable const&) = delete;
+    FutexConditionVariable(FutexConditionVariable&&) = delete;
+
+    // Resets the condition variable, inter_process has no effect
+    [[nodiscard]] auto Initialize(bool inter_process = false) -> std::expected<void, PikaError>;
+    template <typename Predicate> void Wait(FutexMutex& locked_mutex, Predicate stop_waiting)
+    {
+        // Pre condition: Caller must ensure locked_mutex was locked
+        while (stop_waiting() == false) {
+            static_cast<void>(wait(locked_mutex, Deadline { pika::INFINITE_TIMEOUT }));
+        }
+    }
+    // Like Wait but gives up once the deadline expires. Returns the final value of the
+    // predicate, the mutex is locked again in either case.
+    template <typename Predicate>
+    [[nodiscard]] auto WaitUntil(FutexMutex& locked_mutex, Deadline const& deadline,
+        Predicate stop_waiting) -> bool
+    {
+        while (stop_waiting() == false) {
+            if (not wait(locked_mutex, deadline)) {
+                return stop_waiting();
+            }
+        }
+        return true;
+    }
+    void Signal() { wake(false); }
+    void Broadcast() { wake(true); }
+
+private:
+    [[nodiscard]] auto getSequenceWord() const -> uint32_t const*
+    {
+        return reinterpret_cast<uint32_t const*>(&m_sequence);
+    }
+    // Unlocks locked_mutex, sleeps until granted a wakeup and locks locked_mutex again. Returns
+    // false if the deadline expired first.
+    auto wait(FutexMutex& locked_mutex, Deadline const& deadline) -> bool;
+    auto wake(bool wake_all) -> void;
+
+    // Protects the counters below
+    FutexMutex m_internal_mutex;
+    // Futex word, bumped on every granted wakeup
+    std::atomic_uint32_t m_sequence = 0;
+    // Number of waits started, wakeups granted and wakeups consumed
+    std::atomic_uint32_t m_total_count = 0;
+    std::atomic_uint32_t m_wakeup_count = 0;
+    std::atomic_uint32_t m_woken_count = 0;
+};
+
 struct LockedMutex {
     [[nodiscard]] static auto New(Mutex* mutex) -> std::expected<LockedMutex, PikaError>;
     [[nodiscard]] static auto New(Mutex* mutex, DurationUs duration)
@@ -122,6 +288,28 @@ struct ConditionVariable {
             }
         }
     }
+    // Like Wait but gives up once the deadline expires. Returns the final value of the
+    // predicate, the mutex is locked again in either case.
+    template <typename Predicate>
+    [[nodiscard]] auto WaitUntil(Mutex& locked_mutex, Deadline const& deadline,
+        Predicate stop_waiting) -> bool
+    {
+        auto const absolute_deadline = deadline.GetMonotonicTimespec();
+        while (stop_waiting() == false) {
+            auto status = deadline.IsInfinite()
+                ? pthread_cond_wait(&m_pthread_cond, &locked_mutex.m_pthread_mutex)
+                : pthread_cond_timedwait(
+                      &m_pthread_cond, &locked_mutex.m_pthread_mutex, &absolute_deadline);
+            if (status == ETIMEDOUT) {
+                return stop_waiting();
+            }
+            if (status != 0) {
+                fmt::println(stderr, "pthread_cond_timedwait failed with return code{}", status);
+                return stop_waiting();
+            }
+        }
+        return true;
+    }
     void Signal()
     {
         auto status = pthread_cond_signal(&m_pthread_cond);
@@ -129,6 +317,13 @@ struct ConditionVariable {
             fmt::println(stderr, "pthread_cond_wait failed with return code{}", status);
         }
     }
+    void Broadcast()
+    {
+        auto status = pthread_cond_broadcast(&m_pthread_cond);
+        if (status != 0) {
+            fmt::println(stderr, "pthread_cond_broadcast failed with return code{}", status);
+        }
+    }
     ConditionVariable() = default;
     ConditionVariable(ConditionVariable const&) = delete;
     ConditionVariable(ConditionVariable&&) = delete;
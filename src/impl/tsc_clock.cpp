@@ -0,0 +1,100 @@
+// MIT License
+
+// Copyright (c) 2023 Kevin Joseph
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "tsc_clock.hpp"
+
+#include <mutex>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+static std::mutex g_calibration_mutex;
+
+static auto MeasureCalibration() -> TscCalibration
+{
+#if defined(__x86_64__) || defined(__i386__)
+    if (not TscClock::HasInvariantTsc()) {
+        return {};
+    }
+    // Bracket each clock_gettime with TSC reads and pair it with their midpoint
+    auto const sample = [](uint64_t& ticks, uint64_t& monotonic_ns) {
+        auto const ticks_before = __rdtsc();
+        monotonic_ns = TscClock::GetMonotonicNs();
+        auto const ticks_after = __rdtsc();
+        ticks = ticks_before + ((ticks_after - ticks_before) / 2);
+    };
+    TscCalibration calibration {};
+    sample(calibration.reference_ticks, calibration.reference_monotonic_ns);
+    timespec const calibration_period { .tv_sec = 0, .tv_nsec = 10'000'000 };
+    nanosleep(&calibration_period, nullptr);
+    uint64_t ticks = 0;
+    uint64_t monotonic_ns = 0;
+    sample(ticks, monotonic_ns);
+    if (ticks <= calibration.reference_ticks) {
+        return {};
+    }
+    calibration.ns_per_tick = static_cast<double>(monotonic_ns - calibration.reference_monotonic_ns)
+        / static_cast<double>(ticks - calibration.reference_ticks);
+    return calibration;
+#else
+    return {};
+#endif
+}
+
+auto TscClock::HasInvariantTsc() -> bool
+{
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
+    }
+    return (edx & (1U << 8)) != 0;
+#else
+    return false;
+#endif
+}
+
+auto TscClock::calibrateOnce() -> TscCalibration const&
+{
+    std::lock_guard lock(g_calibration_mutex);
+    if (not s_calibrated.load(std::memory_order_relaxed)) {
+        s_calibration = MeasureCalibration();
+        s_calibrated.store(true, std::memory_order_release);
+    }
+    return s_calibration;
+}
+
+auto TscClock::AdoptCalibration(TscCalibration const& calibration) -> void
+{
+    // Only meaningful if this machine's TSC is usable as well
+    if (calibration.UsesTsc() && not HasInvariantTsc()) {
+        return;
+    }
+    std::lock_guard lock(g_calibration_mutex);
+    if (not s_calibrated.load(std::memory_order_relaxed)) {
+        s_calibration = calibration;
+        s_calibrated.store(true, std::memory_order_release);
+    }
+}
@@ -0,0 +1,103 @@
+// MIT License
+
+// Copyright (c) 2023 Kevin Joseph
+
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef PIKA_TSC_CLOCK_HPP
+#define PIKA_TSC_CLOCK_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// Conversion from time stamp counter ticks to CLOCK_MONOTONIC. Plain data so that it can be
+// stored in the ChannelHeader: every process attached to a channel converts with the calibration
+// of the process that created it, which makes their timestamps comparable.
+struct TscCalibration {
+    uint64_t reference_ticks = 0; // TSC reading at the calibration point
+    uint64_t reference_monotonic_ns = 0; // CLOCK_MONOTONIC at the same point
+    double ns_per_tick = 0.0; // 0 when the TSC is not used
+    [[nodiscard]] auto UsesTsc() const -> bool { return ns_per_tick > 0.0; }
+};
+
+// Clock for timeouts checked in spin loops and for latency measurements. Reading the TSC costs a
+// few nanoseconds where std::chrono::steady_clock::now() costs about 20. The TSC is calibrated
+// once per process against CLOCK_MONOTONIC, or the calibration of an existing channel is adopted.
+// Without an invariant TSC(or on other architectures) the clock falls back to CLOCK_MONOTONIC
+// and ticks are nanoseconds.
+struct TscClock {
+    // Ticks since an arbitrary origin, only differences and ToMonotonicNs are meaningful
+    [[nodiscard]] static auto Now() -> uint64_t
+    {
+#if defined(__x86_64__) || defined(__i386__)
+        if (GetCalibration().UsesTsc()) {
+            return __rdtsc();
+        }
+#endif
+        return GetMonotonicNs();
+    }
+    [[nodiscard]] static auto ToNanoseconds(uint64_t ticks) -> uint64_t
+    {
+        auto const& calibration = GetCalibration();
+        return calibration.UsesTsc()
+            ? static_cast<uint64_t>(static_cast<double>(ticks) * calibration.ns_per_tick)
+            : ticks;
+    }
+    // Converts a Now() reading to CLOCK_MONOTONIC nanoseconds
+    [[nodiscard]] static auto ToMonotonicNs(uint64_t ticks) -> uint64_t
+    {
+        auto const& calibration = GetCalibration();
+        if (not calibration.UsesTsc()) {
+            return ticks;
+        }
+        auto const delta_ticks = static_cast<int64_t>(ticks - calibration.reference_ticks);
+        return calibration.reference_monotonic_ns
+            + static_cast<uint64_t>(static_cast<double>(delta_ticks) * calibration.ns_per_tick);
+    }
+    // Calibrates on first use
+    [[nodiscard]] static auto GetCalibration() -> TscCalibration const&
+    {
+        if (s_calibrated.load(std::memory_order_acquire)) {
+            return s_calibration;
+        }
+        return calibrateOnce();
+    }
+    // Uses the calibration of another process unless this process already has one
+    static auto AdoptCalibration(TscCalibration const& calibration) -> void;
+    // Whether the TSC ticks at a constant rate across frequency changes and sleep states
+    [[nodiscard]] static auto HasInvariantTsc() -> bool;
+    [[nodiscard]] static auto GetMonotonicNs() -> uint64_t
+    {
+        timespec now {};
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        return (static_cast<uint64_t>(now.tv_sec) * 1'000'000'000)
+            + static_cast<uint64_t>(now.tv_nsec);
+    }
+
+private:
+    static auto calibrateOnce() -> TscCalibration const&;
+    static inline std::atomic_bool s_calibrated = false;
+    static inline TscCalibration s_calibration {};
+};
+
+#endif
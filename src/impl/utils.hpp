@@ -25,6 +25,7 @@
 
 #include "channel_interface.hpp"
 #include "error.hpp"
+#include "tsc_clock.hpp"
 
 #include <chrono>
 #include <cstdint>
@@ -34,6 +35,20 @@
 
 using namespace pika;
 
+// Shared state written by different cores is kept on separate cache lines of this size to avoid
+// false sharing
+static constexpr uint64_t CACHE_LINE_SIZE = 64;
+
+// Hints the CPU that the caller is in a spin-wait loop
+inline auto CpuRelax() -> void
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
 template <typename Function> struct Defer {
     Defer(Function function)
         : m_function(std::move(function))
@@ -43,21 +58,83 @@ template <typename Function> struct Defer {
     Function m_function;
 };
 
+// Measures timeouts in spin loops, cheap enough to be checked on every iteration. The TSC is
+// calibrated over a short period, a calibration that runs slightly fast would give up early, so
+// expiry is confirmed once on CLOCK_MONOTONIC and the TSC reading corrected by the difference.
+// Construct it only for finite timeouts, reading the TSC is not free either.
 struct Timer {
-    using Clock = std::chrono::steady_clock;
     Timer()
-        : m_start_point(Clock::now())
+        : m_start_ticks(TscClock::Now())
+    {
+    }
+    // Time elapsed since construction, never at or past timeout_duration before CLOCK_MONOTONIC
+    // agrees
+    [[nodiscard]] auto GetElapsedDuration(DurationUs timeout_duration) -> DurationUs
+    {
+        auto const elapsed_ns
+            = TscClock::ToNanoseconds(TscClock::Now() - m_start_ticks) - m_correction_ns;
+        if (elapsed_ns / 1000 < timeout_duration) {
+            return elapsed_ns / 1000;
+        }
+        auto const now_ns = TscClock::GetMonotonicNs();
+        auto const start_ns = TscClock::ToMonotonicNs(m_start_ticks);
+        auto const monotonic_elapsed_ns = now_ns > start_ns ? now_ns - start_ns : 0;
+        if (monotonic_elapsed_ns < elapsed_ns) {
+            m_correction_ns += elapsed_ns - monotonic_elapsed_ns;
+        }
+        return monotonic_elapsed_ns / 1000;
+    }
+
+private:
+    uint64_t m_start_ticks;
+    uint64_t m_correction_ns = 0; // How far the TSC has run ahead of CLOCK_MONOTONIC
+};
+
+// Point in time at which a blocking call given timeout_duration gives up. Calls that block in
+// several steps(e.g. lock a mutex, then wait on a condition variable) share one deadline so that
+// the steps together never exceed the timeout. Measured on CLOCK_MONOTONIC, which
+// std::chrono::steady_clock reads on Linux, so wall clock adjustments do not affect timeouts.
+struct Deadline {
+    using Clock = std::chrono::steady_clock;
+    explicit Deadline(DurationUs timeout_duration)
+        // Timeouts too large to be represented never expire either
+        : m_infinite(timeout_duration >= MAX_TIMEOUT)
+        , m_time_point(m_infinite ? Clock::time_point::max()
+                                  : Clock::now() + std::chrono::microseconds(timeout_duration))
+    {
+    }
+    [[nodiscard]] auto IsInfinite() const -> bool { return m_infinite; }
+    [[nodiscard]] auto HasExpired() const -> bool
+    {
+        return not m_infinite && Clock::now() >= m_time_point;
+    }
+    // INFINITE_TIMEOUT if the deadline is infinite, 0 once it has expired
+    [[nodiscard]] auto GetRemainingDuration() const -> DurationUs
     {
+        if (m_infinite) {
+            return INFINITE_TIMEOUT;
+        }
+        auto const now = Clock::now();
+        if (now >= m_time_point) {
+            return 0;
+        }
+        return static_cast<DurationUs>(
+            std::chrono::ceil<std::chrono::microseconds>(m_time_point - now).count());
     }
-    [[nodiscard]] auto GetElapsedDuration() -> DurationUs
+    // Absolute CLOCK_MONOTONIC time for the pthread_*clock* functions
+    [[nodiscard]] auto GetMonotonicTimespec() const -> timespec
     {
-        return std::chrono::duration_cast<std::chrono::duration<DurationUs, std::micro>>(
-            Clock::now() - m_start_point)
-            .count();
-        ;
+        auto const since_epoch = m_time_point.time_since_epoch();
+        auto const seconds = std::chrono::floor<std::chrono::seconds>(since_epoch);
+        return timespec { .tv_sec = static_cast<decltype(timespec::tv_sec)>(seconds.count()),
+            .tv_nsec = static_cast<decltype(timespec::tv_nsec)>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - seconds)
+                    .count()) };
     }
 
 private:
-    Clock::time_point m_start_point;
+    static constexpr DurationUs MAX_TIMEOUT = DurationUs { 1 } << 51; // About 70 years
+    bool m_infinite;
+    Clock::time_point m_time_point;
 };
 #endif
\ No newline at end of file
@@ -2,13 +2,19 @@
 #include "process_fork.hpp"
 #include "test_utils.hpp"
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <expected>
+#include <memory>
 #include <fmt/core.h>
 #include <gtest/gtest.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
 #include <thread>
+#include <vector>
 
 using namespace std::chrono_literals;
 
@@ -195,6 +201,331 @@ TEST(InterProcessChannel, TxRxLockFree)
         << child_process_handle.error().error_message;
 }
 
+TEST(InterProcessChannel, TxRxBroadcast)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::InterProcess,
+        .queue_mode = pika::QueueMode::Broadcast };
+    auto const tx_data = GetRandomIntVector(100);
+    auto const ready_params = pika::ChannelParameters { .channel_name = "/test_ready",
+        .queue_size = 2,
+        .channel_type = pika::ChannelType::InterProcess };
+    auto producer = pika::Channel::CreateProducer<int>(params);
+    ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+    auto ready_consumer = pika::Channel::CreateConsumer<int>(ready_params);
+    ASSERT_TRUE(ready_consumer.has_value()) << ready_consumer.error().error_message;
+    // Every consumer process receives the full stream
+    auto consumer_function = [&]() -> ChildProcessState {
+        auto consumer = pika::Channel::CreateConsumer<int>(params);
+        if (not consumer.has_value()) {
+            fmt::println(stderr, "{}", consumer.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        auto ready_producer = pika::Channel::CreateProducer<int>(ready_params);
+        if (not ready_producer.has_value() || not ready_producer->Send(1).has_value()) {
+            fmt::println(stderr, "Failed to signal readiness");
+            return ChildProcessState::FAIL;
+        }
+        for (auto const expected_packet : tx_data) {
+            int recv_packet {};
+            auto recv_result = consumer->Receive(recv_packet);
+            if (not recv_result.has_value() || recv_packet != expected_packet) {
+                fmt::println(stderr, "consumer->Receive failed");
+                return ChildProcessState::FAIL;
+            }
+        }
+        return ChildProcessState::SUCCESS;
+    };
+    auto child_process_handle_1 = ChildProcessHandle::RunChildFunction(consumer_function);
+    ASSERT_TRUE(child_process_handle_1.has_value())
+        << child_process_handle_1.error().error_message;
+    auto child_process_handle_2 = ChildProcessHandle::RunChildFunction(consumer_function);
+    ASSERT_TRUE(child_process_handle_2.has_value())
+        << child_process_handle_2.error().error_message;
+
+    // Consumers only see messages published after they registered, wait for both cursors
+    for (int i = 0; i < 2; ++i) {
+        int ready {};
+        ASSERT_TRUE(ready_consumer->Receive(ready).has_value());
+    }
+    for (auto const packet : tx_data) {
+        ASSERT_TRUE(producer->Send(packet).has_value());
+    }
+    ASSERT_TRUE(child_process_handle_1->WaitForChildProcess().has_value());
+    ASSERT_TRUE(child_process_handle_2->WaitForChildProcess().has_value());
+}
+
+TEST(InterProcessChannel, TxRxBytesMirrored)
+{
+    auto params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 4096,
+        .channel_type = pika::ChannelType::InterProcess,
+        .mirrored_mapping_mode = true };
+    // Mirroring is limited to byte stream channels backed by shared memory
+    ASSERT_FALSE(pika::Channel::CreateProducer<int>(params).has_value());
+    params.channel_type = pika::ChannelType::InterThread;
+    ASSERT_FALSE(pika::Channel::CreateByteProducer(params).has_value());
+    params.channel_type = pika::ChannelType::InterProcess;
+
+    auto const tx_data = GetRandomIntVector(200);
+    auto child_process_handle = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+        auto producer = pika::Channel::CreateByteProducer(params);
+        if (not producer.has_value()) {
+            fmt::println(stderr, "{}", producer.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        auto connect_result = producer->Connect();
+        if (not connect_result.has_value()) {
+            fmt::println(stderr, "{}", connect_result.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        // Record sizes that do not divide the ring size, so records keep crossing its end
+        for (auto const value : tx_data) {
+            auto const message = std::vector<std::byte>(
+                static_cast<size_t>(value) * 13, static_cast<std::byte>(value));
+            auto send_result = producer->SendBytes(message);
+            if (not send_result.has_value()) {
+                fmt::println(stderr, "producer->SendBytes Error: {}",
+                    send_result.error().error_message);
+                return ChildProcessState::FAIL;
+            }
+        }
+        return ChildProcessState::SUCCESS;
+    });
+    ASSERT_TRUE(child_process_handle.has_value()) << child_process_handle.error().error_message;
+    auto consumer = pika::Channel::CreateByteConsumer(params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+    auto connect_result = consumer->Connect();
+    ASSERT_TRUE(connect_result.has_value()) << connect_result.error().error_message;
+
+    for (auto const value : tx_data) {
+        // Every message is readable in place, including the ones crossing the end of the ring
+        auto message = consumer->GetReceiveBytes();
+        ASSERT_TRUE(message.has_value()) << message.error().error_message;
+        ASSERT_EQ(message->size(), static_cast<size_t>(value) * 13);
+        ASSERT_TRUE(std::all_of(message->begin(), message->end(),
+            [&](std::byte byte) { return byte == static_cast<std::byte>(value); }));
+        ASSERT_TRUE(consumer->ReleaseReceiveBytes(*message).has_value());
+    }
+
+    auto child_process_exit_status = child_process_handle->WaitForChildProcess();
+    ASSERT_TRUE(child_process_exit_status.has_value())
+        << child_process_handle.error().error_message;
+}
+
+TEST(InterProcessChannel, TxRxLockFreeParked)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::InterProcess,
+        .single_producer_single_consumer_mode = true,
+        .wait_strategy = { .type = pika::WaitStrategyType::SpinPark, .spin_budget = 16 } };
+    auto const tx_data = GetRandomIntVector(100);
+    auto child_process_handle = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+        auto producer = pika::Channel::CreateProducer<int>(params);
+        if (not producer.has_value()) {
+            fmt::println(stderr, "{}", producer.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        auto connect_result = producer->Connect();
+        if (not connect_result.has_value()) {
+            fmt::println(stderr, "{}", connect_result.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        for (size_t i = 0; i < tx_data.size(); ++i) {
+            if (i % 10 == 0) {
+                // Let the consumer run out of its spin budget and park
+                std::this_thread::sleep_for(1ms);
+            }
+            auto send_result = producer->Send(tx_data[i]);
+            if (not send_result.has_value()) {
+                fmt::println(stderr, "producer->Send Error: {}", send_result.error().error_message);
+                return ChildProcessState::FAIL;
+            }
+        }
+        return ChildProcessState::SUCCESS;
+    });
+    ASSERT_TRUE(child_process_handle.has_value()) << child_process_handle.error().error_message;
+    // Setup consumer
+    auto consumer = pika::Channel::CreateConsumer<int>(params);
+    auto connect_result = consumer->Connect();
+    ASSERT_TRUE(connect_result.has_value()) << connect_result.error().error_message;
+
+    // Parks with an infinite timeout, only the producer's wakeups let this loop make progress
+    for (auto const expected_packet : tx_data) {
+        int recv_packet {};
+        auto recv_result = consumer->Receive(recv_packet);
+        ASSERT_TRUE(recv_result.has_value()) << recv_result.error().error_message;
+        ASSERT_EQ(recv_packet, expected_packet);
+    }
+
+    auto child_process_exit_status = child_process_handle->WaitForChildProcess();
+    ASSERT_TRUE(child_process_exit_status.has_value())
+        << child_process_handle.error().error_message;
+}
+
+TEST(InterProcessChannel, TxRxLockFreeMultiProducerMultiConsumer)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::InterProcess,
+        .queue_mode = pika::QueueMode::LockFree };
+    auto const tx_data = GetRandomIntVector(100);
+    auto child_process_handle = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+        auto producer = pika::Channel::CreateProducer<int>(params);
+        if (not producer.has_value()) {
+            fmt::println(stderr, "{}", producer.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        auto connect_result = producer->Connect();
+        if (not connect_result.has_value()) {
+            fmt::println(stderr, "{}", connect_result.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        for (auto tx : tx_data) {
+            auto send_result = producer->Send(static_cast<int>(tx));
+            if (not send_result.has_value()) {
+                fmt::println(stderr, "producer->Send Error: {}", send_result.error().error_message);
+                return ChildProcessState::FAIL;
+            }
+        }
+        return ChildProcessState::SUCCESS;
+    });
+    ASSERT_TRUE(child_process_handle.has_value()) << child_process_handle.error().error_message;
+    // Setup consumer
+    auto consumer = pika::Channel::CreateConsumer<int>(params);
+    auto connect_result = consumer->Connect();
+    ASSERT_TRUE(connect_result.has_value()) << connect_result.error().error_message;
+
+    for (auto expected_packet : tx_data) {
+        int recv_packet {};
+        auto recv_result = consumer->Receive(recv_packet);
+        ASSERT_TRUE(recv_result.has_value()) << recv_result.error().error_message;
+        ASSERT_EQ(recv_packet, expected_packet);
+    }
+
+    auto child_process_exit_status = child_process_handle->WaitForChildProcess();
+    ASSERT_TRUE(child_process_exit_status.has_value())
+        << child_process_handle.error().error_message;
+}
+
+TEST(InterProcessChannel, TxRxFutexMutex)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::InterProcess,
+        .futex_mutex_mode = true };
+    constexpr int NUMBER_OF_PRODUCERS = 4;
+    constexpr int PACKETS_PER_PRODUCER = 1000;
+    auto child_process_handle = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+        std::vector<std::thread> producers;
+        std::atomic_bool success = true;
+        for (int producer_index = 0; producer_index < NUMBER_OF_PRODUCERS; ++producer_index) {
+            producers.emplace_back([&, producer_index]() {
+                auto producer = pika::Channel::CreateProducer<int>(params);
+                if (not producer.has_value()) {
+                    fmt::println(stderr, "{}", producer.error().error_message);
+                    success = false;
+                    return;
+                }
+                for (int i = 0; i < PACKETS_PER_PRODUCER; ++i) {
+                    auto send_result = producer->Send(producer_index * PACKETS_PER_PRODUCER + i);
+                    if (not send_result.has_value()) {
+                        fmt::println(stderr, "producer->Send Error: {}",
+                            send_result.error().error_message);
+                        success = false;
+                        return;
+                    }
+                }
+            });
+        }
+        for (auto& thread : producers) {
+            thread.join();
+        }
+        return success ? ChildProcessState::SUCCESS : ChildProcessState::FAIL;
+    });
+    ASSERT_TRUE(child_process_handle.has_value()) << child_process_handle.error().error_message;
+    auto consumer = pika::Channel::CreateConsumer<int>(params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+    // Packets of every producer arrive in order
+    std::vector<int> next_packets(NUMBER_OF_PRODUCERS);
+    for (int producer_index = 0; producer_index < NUMBER_OF_PRODUCERS; ++producer_index) {
+        next_packets[static_cast<size_t>(producer_index)] = producer_index * PACKETS_PER_PRODUCER;
+    }
+    for (int i = 0; i < NUMBER_OF_PRODUCERS * PACKETS_PER_PRODUCER; ++i) {
+        int recv_packet {};
+        auto recv_result = consumer->Receive(recv_packet);
+        ASSERT_TRUE(recv_result.has_value()) << recv_result.error().error_message;
+        auto& next_packet = next_packets[static_cast<size_t>(recv_packet / PACKETS_PER_PRODUCER)];
+        ASSERT_EQ(recv_packet, next_packet);
+        ++next_packet;
+    }
+
+    auto child_process_exit_status = child_process_handle->WaitForChildProcess();
+    ASSERT_TRUE(child_process_exit_status.has_value())
+        << child_process_handle.error().error_message;
+}
+
+TEST(InterProcessChannel, TxRxTwoLock)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::InterProcess,
+        .queue_mode = pika::QueueMode::TwoLock };
+    constexpr int NUMBER_OF_PRODUCERS = 4;
+    constexpr int PACKETS_PER_PRODUCER = 1000;
+    auto child_process_handle = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+        std::vector<std::thread> producers;
+        std::atomic_bool success = true;
+        for (int producer_index = 0; producer_index < NUMBER_OF_PRODUCERS; ++producer_index) {
+            producers.emplace_back([&, producer_index]() {
+                auto producer = pika::Channel::CreateProducer<int>(params);
+                if (not producer.has_value()) {
+                    fmt::println(stderr, "{}", producer.error().error_message);
+                    success = false;
+                    return;
+                }
+                for (int i = 0; i < PACKETS_PER_PRODUCER; ++i) {
+                    auto send_result = producer->Send(producer_index * PACKETS_PER_PRODUCER + i);
+                    if (not send_result.has_value()) {
+                        fmt::println(stderr, "producer->Send Error: {}",
+                            send_result.error().error_message);
+                        success = false;
+                        return;
+                    }
+                }
+            });
+        }
+        for (auto& thread : producers) {
+            thread.join();
+        }
+        return success ? ChildProcessState::SUCCESS : ChildProcessState::FAIL;
+    });
+    ASSERT_TRUE(child_process_handle.has_value()) << child_process_handle.error().error_message;
+    auto consumer = pika::Channel::CreateConsumer<int>(params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+    // Packets of every producer arrive in order
+    std::vector<int> next_packets(NUMBER_OF_PRODUCERS);
+    for (int producer_index = 0; producer_index < NUMBER_OF_PRODUCERS; ++producer_index) {
+        next_packets[static_cast<size_t>(producer_index)] = producer_index * PACKETS_PER_PRODUCER;
+    }
+    for (int i = 0; i < NUMBER_OF_PRODUCERS * PACKETS_PER_PRODUCER; ++i) {
+        int recv_packet {};
+        auto recv_result = consumer->Receive(recv_packet);
+        ASSERT_TRUE(recv_result.has_value()) << recv_result.error().error_message;
+        auto& next_packet = next_packets[static_cast<size_t>(recv_packet / PACKETS_PER_PRODUCER)];
+        ASSERT_EQ(recv_packet, next_packet);
+        ++next_packet;
+    }
+
+    auto child_process_exit_status = child_process_handle->WaitForChildProcess();
+    ASSERT_TRUE(child_process_exit_status.has_value())
+        << child_process_handle.error().error_message;
+}
+
 TEST(InterProcessChannel, TxRxWithTimeouts)
 {
     auto const params = pika::ChannelParameters {
@@ -331,10 +662,327 @@ TEST(InterProcessChannel, TxRxZeroCopyLockFree)
         .queue_size = 4,
         .channel_type = pika::ChannelType::InterProcess,
         .single_producer_single_consumer_mode = true };
+    auto const tx_data = GetRandomIntVector(100);
 
     // Setup consumer
     auto consumer = pika::Channel::CreateConsumer<int>(params);
-    auto recv_result = consumer->GetReceiveSlot(1000);
-    ASSERT_FALSE(recv_result.has_value());
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+    auto empty_recv_result = consumer->GetReceiveSlot(1000);
+    ASSERT_FALSE(empty_recv_result.has_value());
+    ASSERT_EQ(empty_recv_result.error().error_type, PikaErrorType::Timeout);
     ASSERT_FALSE(consumer->ReleaseReceiveSlot(nullptr).has_value());
-}
\ No newline at end of file
+
+    auto child_process_handle = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+        auto producer = pika::Channel::CreateProducer<int>(params);
+        if (not producer.has_value()) {
+            fmt::println(stderr, "{}", producer.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        auto connect_result = producer->Connect();
+        if (not connect_result.has_value()) {
+            fmt::println(stderr, "{}", connect_result.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        for (auto tx : tx_data) {
+            auto slot = producer->GetSendSlot();
+            if (not slot.has_value()) {
+                fmt::println(stderr, "producer->GetSendSlot Error: {}", slot.error().error_message);
+                return ChildProcessState::FAIL;
+            }
+            *(slot.value()) = tx;
+            auto send_result = producer->ReleaseSendSlot(slot.value());
+            if (not send_result.has_value()) {
+                fmt::println(stderr, "producer->ReleaseSendSlot Error: {}",
+                    send_result.error().error_message);
+                return ChildProcessState::FAIL;
+            }
+        }
+        return ChildProcessState::SUCCESS;
+    });
+    ASSERT_TRUE(child_process_handle.has_value()) << child_process_handle.error().error_message;
+    auto connect_result = consumer->Connect();
+    ASSERT_TRUE(connect_result.has_value()) << connect_result.error().error_message;
+
+    for (auto expected_packet : tx_data) {
+        auto recv_result = consumer->GetReceiveSlot();
+        ASSERT_TRUE(recv_result.has_value()) << recv_result.error().error_message;
+        ASSERT_EQ(*(recv_result.value()), expected_packet);
+        ASSERT_TRUE(consumer->ReleaseReceiveSlot(recv_result.value()).has_value());
+    }
+
+    auto child_process_exit_status = child_process_handle->WaitForChildProcess();
+    ASSERT_TRUE(child_process_exit_status.has_value())
+        << child_process_handle.error().error_message;
+}
+TEST(InterProcessChannel, HugePages)
+{
+    for (auto const huge_page_mode :
+        { pika::HugePageMode::Transparent, pika::HugePageMode::Explicit }) {
+        auto const params = pika::ChannelParameters { .channel_name = "/test",
+            .queue_size = 1 << 20,
+            .channel_type = pika::ChannelType::InterProcess,
+            .single_producer_single_consumer_mode = true,
+            .huge_page_mode = huge_page_mode };
+        auto producer = pika::Channel::CreateProducer<uint64_t>(params);
+        ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+        auto consumer = pika::Channel::CreateConsumer<uint64_t>(params);
+        ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+        // Either huge pages are in effect or the fallback to regular pages is explained
+        auto const backing = producer->GetSegmentBacking();
+        if (backing.huge_page_mode == huge_page_mode) {
+            ASSERT_TRUE(backing.fallback_reason.empty());
+            ASSERT_GT(backing.page_size, 4096);
+        } else {
+            ASSERT_EQ(backing.huge_page_mode, pika::HugePageMode::None);
+            ASSERT_FALSE(backing.fallback_reason.empty());
+            fmt::println("Huge pages not available: {}", backing.fallback_reason);
+        }
+        ASSERT_EQ(consumer->GetSegmentBacking().huge_page_mode, backing.huge_page_mode);
+
+        for (uint64_t i = 0; i < (1 << 20); i += 4096) {
+            ASSERT_TRUE(producer->Send(i).has_value());
+        }
+        uint64_t recv_packet {};
+        for (uint64_t i = 0; i < (1 << 20); i += 4096) {
+            ASSERT_TRUE(consumer->Receive(recv_packet).has_value());
+            ASSERT_EQ(recv_packet, i);
+        }
+    }
+
+    // Endpoints that do not ask for huge pages join a channel established on them
+    auto const explicit_params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 1 << 10,
+        .channel_type = pika::ChannelType::InterProcess,
+        .single_producer_single_consumer_mode = true,
+        .huge_page_mode = pika::HugePageMode::Explicit };
+    auto producer = pika::Channel::CreateProducer<uint64_t>(explicit_params);
+    ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+    auto regular_params = explicit_params;
+    regular_params.huge_page_mode = pika::HugePageMode::None;
+    auto consumer = pika::Channel::CreateConsumer<uint64_t>(regular_params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+    ASSERT_EQ(consumer->GetSegmentBacking().huge_page_mode,
+        producer->GetSegmentBacking().huge_page_mode);
+    ASSERT_TRUE(producer->Send(42).has_value());
+    uint64_t recv_packet {};
+    ASSERT_TRUE(consumer->Receive(recv_packet).has_value());
+    ASSERT_EQ(recv_packet, 42);
+
+    auto const mirrored_params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 1 << 16,
+        .channel_type = pika::ChannelType::InterProcess,
+        .mirrored_mapping_mode = true,
+        .huge_page_mode = pika::HugePageMode::Explicit };
+    ASSERT_FALSE(pika::Channel::CreateByteProducer(mirrored_params).has_value());
+}
+
+TEST(InterProcessChannel, PrefaultAndLockMemory)
+{
+    static constexpr auto QUEUE_SIZE = uint64_t { 1 << 16 };
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = QUEUE_SIZE,
+        .channel_type = pika::ChannelType::InterProcess,
+        .single_producer_single_consumer_mode = true,
+        .prefault_mode = true,
+        .lock_memory_mode = true };
+    auto producer = pika::Channel::CreateProducer<uint64_t>(params);
+    ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+    auto consumer = pika::Channel::CreateConsumer<uint64_t>(params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+    // The whole ring is resident, the first pass over its 128 pages takes no page faults
+    auto const get_page_fault_count = []() {
+        rusage usage {};
+        getrusage(RUSAGE_SELF, &usage);
+        return usage.ru_minflt + usage.ru_majflt;
+    };
+    auto const page_fault_count = get_page_fault_count();
+    for (uint64_t i = 0; i < QUEUE_SIZE; ++i) {
+        ASSERT_TRUE(producer->Send(i).has_value());
+    }
+    uint64_t recv_packet {};
+    for (uint64_t i = 0; i < QUEUE_SIZE; ++i) {
+        ASSERT_TRUE(consumer->Receive(recv_packet).has_value());
+        ASSERT_EQ(recv_packet, i);
+    }
+    ASSERT_LT(get_page_fault_count() - page_fault_count, 16);
+}
+
+TEST(InterProcessChannel, NumaPlacement)
+{
+    for (auto const numa_policy : { pika::NumaPolicy::Bind, pika::NumaPolicy::Interleave,
+             pika::NumaPolicy::FollowConsumer }) {
+        auto const params = pika::ChannelParameters { .channel_name = "/test",
+            .queue_size = 1 << 16,
+            .channel_type = pika::ChannelType::InterProcess,
+            .single_producer_single_consumer_mode = true,
+            .prefault_mode = true,
+            .numa_policy = numa_policy,
+            .numa_node = 0 };
+        auto producer = pika::Channel::CreateProducer<uint64_t>(params);
+        ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+        auto consumer = pika::Channel::CreateConsumer<uint64_t>(params);
+        ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+        // The node is recorded in the channel header, all endpoints report the same one
+        auto const numa_node = producer->GetSegmentBacking().numa_node;
+        ASSERT_EQ(consumer->GetSegmentBacking().numa_node, numa_node);
+        if (numa_policy == pika::NumaPolicy::Bind) {
+            ASSERT_EQ(numa_node, 0);
+        } else if (numa_policy == pika::NumaPolicy::Interleave) {
+            ASSERT_EQ(numa_node, -1);
+        } else {
+            ASSERT_GE(numa_node, 0);
+        }
+        ASSERT_TRUE(producer->Send(42).has_value());
+        uint64_t recv_packet {};
+        ASSERT_TRUE(consumer->Receive(recv_packet).has_value());
+        ASSERT_EQ(recv_packet, 42);
+
+        // Endpoints must agree on the placement
+        auto mismatched_params = params;
+        mismatched_params.numa_policy = pika::NumaPolicy::Default;
+        ASSERT_FALSE(pika::Channel::CreateConsumer<uint64_t>(mismatched_params).has_value());
+    }
+
+    auto const invalid_params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::InterProcess,
+        .numa_policy = pika::NumaPolicy::Bind,
+        .numa_node = 1000 };
+    ASSERT_FALSE(pika::Channel::CreateProducer<uint64_t>(invalid_params).has_value());
+}
+
+TEST(InterProcessChannel, AnonymousChannel)
+{
+    auto channel_fd = pika::Channel::CreateAnonymousChannel();
+    ASSERT_TRUE(channel_fd.has_value()) << channel_fd.error().error_message;
+    int sockets[2] = { -1, -1 };
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets), 0);
+    constexpr int NUMBER_OF_PACKETS = 1000;
+    auto child_process_handle = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+        // Use the descriptor passed over the socket rather than the inherited one
+        close(*channel_fd);
+        auto received_fd = pika::Channel::ReceiveChannelFd(sockets[1]);
+        if (not received_fd.has_value()) {
+            fmt::println(stderr, "{}", received_fd.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        auto const params = pika::ChannelParameters { .channel_name {},
+            .queue_size = 4,
+            .channel_type = pika::ChannelType::AnonymousInterProcess,
+            .channel_fd = *received_fd };
+        auto consumer = pika::Channel::CreateConsumer<int>(params);
+        close(*received_fd);
+        if (not consumer.has_value()) {
+            fmt::println(stderr, "{}", consumer.error().error_message);
+            return ChildProcessState::FAIL;
+        }
+        for (int i = 0; i < NUMBER_OF_PACKETS; ++i) {
+            int recv_packet {};
+            auto recv_result = consumer->Receive(recv_packet);
+            if (not recv_result.has_value() || recv_packet != i) {
+                return ChildProcessState::FAIL;
+            }
+        }
+        return ChildProcessState::SUCCESS;
+    });
+    ASSERT_TRUE(child_process_handle.has_value()) << child_process_handle.error().error_message;
+    auto const params = pika::ChannelParameters { .channel_name {},
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::AnonymousInterProcess,
+        .channel_fd = *channel_fd };
+    auto producer = pika::Channel::CreateProducer<int>(params);
+    ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+    ASSERT_TRUE(pika::Channel::SendChannelFd(sockets[0], *channel_fd).has_value());
+    // The endpoint keeps the memory alive
+    close(*channel_fd);
+    for (int i = 0; i < NUMBER_OF_PACKETS; ++i) {
+        auto send_result = producer->Send(i);
+        ASSERT_TRUE(send_result.has_value()) << send_result.error().error_message;
+    }
+    auto child_process_exit_status = child_process_handle->WaitForChildProcess();
+    ASSERT_TRUE(child_process_exit_status.has_value())
+        << child_process_handle.error().error_message;
+    close(sockets[0]);
+    close(sockets[1]);
+
+    // Anonymous endpoints cannot be created without a descriptor
+    auto const missing_fd_params = pika::ChannelParameters { .channel_name {},
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::AnonymousInterProcess };
+    ASSERT_FALSE(pika::Channel::CreateProducer<int>(missing_fd_params).has_value());
+
+    // Huge pages are used when available, otherwise the reason is reported
+    auto huge_page_fd = pika::Channel::CreateAnonymousChannel(pika::HugePageMode::Explicit);
+    ASSERT_TRUE(huge_page_fd.has_value()) << huge_page_fd.error().error_message;
+    auto const huge_page_params = pika::ChannelParameters { .channel_name {},
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::AnonymousInterProcess,
+        .huge_page_mode = pika::HugePageMode::Explicit,
+        .channel_fd = *huge_page_fd };
+    auto huge_page_producer = pika::Channel::CreateProducer<int>(huge_page_params);
+    close(*huge_page_fd);
+    ASSERT_TRUE(huge_page_producer.has_value()) << huge_page_producer.error().error_message;
+    auto const backing = huge_page_producer->GetSegmentBacking();
+    ASSERT_TRUE(backing.huge_page_mode == pika::HugePageMode::Explicit
+        || not backing.fallback_reason.empty());
+}
+
+TEST(InterProcessChannel, ConcurrentSetup)
+{
+    // Endpoints of two processes race to initialize the header of a fresh channel
+    auto const params = pika::ChannelParameters { .channel_name = "/test_concurrent_setup",
+        .queue_size = 64,
+        .channel_type = pika::ChannelType::InterProcess,
+        .queue_mode = pika::QueueMode::LockFree };
+    constexpr int NUMBER_OF_THREADS = 4;
+    // Producers are kept alive until the consumer is done, the first endpoint destroyed removes
+    // the channel's name
+    using Producers = std::vector<std::unique_ptr<pika::Producer<int>>>;
+    auto const create_producers = [&](Producers& producers) -> bool {
+        producers.resize(NUMBER_OF_THREADS);
+        std::vector<std::thread> threads;
+        for (int thread_index = 0; thread_index < NUMBER_OF_THREADS; ++thread_index) {
+            threads.emplace_back([&, thread_index]() {
+                auto producer = pika::Channel::CreateProducerOnHeap<int>(params);
+                if (producer.has_value() && (*producer)->Send(1).has_value()) {
+                    producers[static_cast<size_t>(thread_index)] = std::move(*producer);
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return std::ranges::all_of(
+            producers, [](auto const& producer) { return producer != nullptr; });
+    };
+    auto child_process_handle = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+        Producers producers;
+        auto producer_thread = std::thread([&]() { create_producers(producers); });
+        auto consumer = pika::Channel::CreateConsumer<int>(params);
+        if (not consumer.has_value()) {
+            producer_thread.join();
+            return ChildProcessState::FAIL;
+        }
+        for (int i = 0; i < 2 * NUMBER_OF_THREADS; ++i) {
+            int recv_packet {};
+            if (not consumer->Receive(recv_packet).has_value() || recv_packet != 1) {
+                producer_thread.join();
+                return ChildProcessState::FAIL;
+            }
+        }
+        producer_thread.join();
+        return ChildProcessState::SUCCESS;
+    });
+    ASSERT_TRUE(child_process_handle.has_value()) << child_process_handle.error().error_message;
+    Producers producers;
+    ASSERT_TRUE(create_producers(producers));
+    auto child_process_exit_status = child_process_handle->WaitForChildProcess();
+    ASSERT_TRUE(child_process_exit_status.has_value())
+        << child_process_handle.error().error_message;
+
+    // The header is guarded in the segment itself, no named semaphore is left behind
+    ASSERT_NE(access("/dev/shm/sem.test_concurrent_setup_inter_process", F_OK), 0);
+}
@@ -3,16 +3,39 @@
 #include "test_utils.hpp"
 
 #include <__expected/expected.h>
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
+#include <cstdlib>
 #include <expected>
 #include <fmt/core.h>
 #include <gtest/gtest.h>
+#include <span>
 #include <thread>
+#include <type_traits>
+#include <vector>
 
 using namespace std::chrono_literals;
 
+// Counts the heap allocations of the test binary while armed. Allocates with malloc, which the
+// default operator delete releases with free.
+static std::atomic_bool g_count_allocations = false;
+static std::atomic_uint64_t g_allocation_count = 0;
+
+auto operator new(std::size_t size) -> void*
+{
+    if (g_count_allocations.load(std::memory_order_relaxed)) {
+        g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto* const pointer = std::malloc(size == 0 ? 1 : size);
+    if (pointer == nullptr) {
+        std::abort();
+    }
+    return pointer;
+}
+
 TEST(InterThreadChannel, BasicTest)
 {
     auto params = pika::ChannelParameters {
@@ -141,6 +164,855 @@ TEST(InterThreadChannel, TxRxLockFree)
     thread.join();
 }
 
+TEST(InterThreadChannel, TxRxLockFreeMultiProducerMultiConsumer)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 8,
+        .channel_type = pika::ChannelType::InterThread,
+        .queue_mode = pika::QueueMode::LockFree };
+    constexpr int NUMBER_OF_PRODUCERS = 4;
+    constexpr int NUMBER_OF_CONSUMERS = 2;
+    constexpr int PACKETS_PER_PRODUCER = 1000;
+
+    // Keep one endpoint of each kind alive so that the channel outlives all the threads
+    auto producer_anchor = pika::Channel::CreateProducer<int>(params);
+    ASSERT_TRUE(producer_anchor.has_value()) << producer_anchor.error().error_message;
+    auto consumer_anchor = pika::Channel::CreateConsumer<int>(params);
+    ASSERT_TRUE(consumer_anchor.has_value()) << consumer_anchor.error().error_message;
+
+    std::vector<std::thread> producers;
+    for (int producer_index = 0; producer_index < NUMBER_OF_PRODUCERS; ++producer_index) {
+        producers.emplace_back([&, producer_index]() {
+            auto producer = pika::Channel::CreateProducer<int>(params);
+            if (not producer.has_value()) {
+                fmt::println(stderr, "{}", producer.error().error_message);
+                return;
+            }
+            for (int i = 0; i < PACKETS_PER_PRODUCER; ++i) {
+                auto send_result = producer->Send(producer_index * PACKETS_PER_PRODUCER + i);
+                if (not send_result.has_value()) {
+                    fmt::println(
+                        stderr, "producer->Send Error: {}", send_result.error().error_message);
+                    return;
+                }
+            }
+        });
+    }
+
+    std::vector<std::vector<int>> received(NUMBER_OF_CONSUMERS);
+    std::vector<std::thread> consumers;
+    for (int consumer_index = 0; consumer_index < NUMBER_OF_CONSUMERS; ++consumer_index) {
+        consumers.emplace_back([&, consumer_index]() {
+            auto consumer = pika::Channel::CreateConsumer<int>(params);
+            if (not consumer.has_value()) {
+                fmt::println(stderr, "{}", consumer.error().error_message);
+                return;
+            }
+            auto const packets_per_consumer
+                = NUMBER_OF_PRODUCERS * PACKETS_PER_PRODUCER / NUMBER_OF_CONSUMERS;
+            for (int i = 0; i < packets_per_consumer; ++i) {
+                int recv_packet {};
+                auto recv_result = consumer->Receive(recv_packet);
+                if (not recv_result.has_value()) {
+                    fmt::println(
+                        stderr, "consumer->Receive Error: {}", recv_result.error().error_message);
+                    return;
+                }
+                received[static_cast<size_t>(consumer_index)].push_back(recv_packet);
+            }
+        });
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    for (auto& thread : consumers) {
+        thread.join();
+    }
+
+    // Every packet must be delivered exactly once and in order per producer
+    std::vector<int> all_received;
+    for (auto const& packets : received) {
+        for (size_t i = 1; i < packets.size(); ++i) {
+            if (packets[i] / PACKETS_PER_PRODUCER == packets[i - 1] / PACKETS_PER_PRODUCER) {
+                ASSERT_LT(packets[i - 1], packets[i]);
+            }
+        }
+        all_received.insert(all_received.end(), packets.begin(), packets.end());
+    }
+    std::sort(all_received.begin(), all_received.end());
+    ASSERT_EQ(all_received.size(), static_cast<size_t>(NUMBER_OF_PRODUCERS * PACKETS_PER_PRODUCER));
+    for (size_t i = 0; i < all_received.size(); ++i) {
+        ASSERT_EQ(all_received[i], static_cast<int>(i));
+    }
+}
+
+TEST(InterThreadChannel, TxRxTwoLock)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 8,
+        .channel_type = pika::ChannelType::InterThread,
+        .queue_mode = pika::QueueMode::TwoLock };
+    constexpr int NUMBER_OF_PRODUCERS = 4;
+    constexpr int NUMBER_OF_CONSUMERS = 4;
+    constexpr int PACKETS_PER_PRODUCER = 1000;
+
+    // Keep one endpoint of each kind alive so that the channel outlives all the threads
+    auto producer_anchor = pika::Channel::CreateProducer<int>(params);
+    ASSERT_TRUE(producer_anchor.has_value()) << producer_anchor.error().error_message;
+    auto consumer_anchor = pika::Channel::CreateConsumer<int>(params);
+    ASSERT_TRUE(consumer_anchor.has_value()) << consumer_anchor.error().error_message;
+
+    std::vector<std::thread> producers;
+    for (int producer_index = 0; producer_index < NUMBER_OF_PRODUCERS; ++producer_index) {
+        producers.emplace_back([&, producer_index]() {
+            auto producer = pika::Channel::CreateProducer<int>(params);
+            if (not producer.has_value()) {
+                fmt::println(stderr, "{}", producer.error().error_message);
+                return;
+            }
+            for (int i = 0; i < PACKETS_PER_PRODUCER; ++i) {
+                auto send_result = producer->Send(producer_index * PACKETS_PER_PRODUCER + i);
+                if (not send_result.has_value()) {
+                    fmt::println(
+                        stderr, "producer->Send Error: {}", send_result.error().error_message);
+                    return;
+                }
+            }
+        });
+    }
+
+    std::vector<std::vector<int>> received(NUMBER_OF_CONSUMERS);
+    std::vector<std::thread> consumers;
+    for (int consumer_index = 0; consumer_index < NUMBER_OF_CONSUMERS; ++consumer_index) {
+        consumers.emplace_back([&, consumer_index]() {
+            auto consumer = pika::Channel::CreateConsumer<int>(params);
+            if (not consumer.has_value()) {
+                fmt::println(stderr, "{}", consumer.error().error_message);
+                return;
+            }
+            auto const packets_per_consumer
+                = NUMBER_OF_PRODUCERS * PACKETS_PER_PRODUCER / NUMBER_OF_CONSUMERS;
+            for (int i = 0; i < packets_per_consumer; ++i) {
+                int recv_packet {};
+                auto recv_result = consumer->Receive(recv_packet);
+                if (not recv_result.has_value()) {
+                    fmt::println(
+                        stderr, "consumer->Receive Error: {}", recv_result.error().error_message);
+                    return;
+                }
+                received[static_cast<size_t>(consumer_index)].push_back(recv_packet);
+            }
+        });
+    }
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    for (auto& thread : consumers) {
+        thread.join();
+    }
+
+    // Every packet must be delivered exactly once and in order per producer
+    std::vector<int> all_received;
+    for (auto const& packets : received) {
+        for (size_t i = 1; i < packets.size(); ++i) {
+            if (packets[i] / PACKETS_PER_PRODUCER == packets[i - 1] / PACKETS_PER_PRODUCER) {
+                ASSERT_LT(packets[i - 1], packets[i]);
+            }
+        }
+        all_received.insert(all_received.end(), packets.begin(), packets.end());
+    }
+    std::sort(all_received.begin(), all_received.end());
+    ASSERT_EQ(all_received.size(), static_cast<size_t>(NUMBER_OF_PRODUCERS * PACKETS_PER_PRODUCER));
+    for (size_t i = 0; i < all_received.size(); ++i) {
+        ASSERT_EQ(all_received[i], static_cast<int>(i));
+    }
+}
+
+TEST(InterThreadChannel, TxRxBroadcast)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 8,
+        .channel_type = pika::ChannelType::InterThread,
+        .queue_mode = pika::QueueMode::Broadcast };
+    auto const tx_data = GetRandomIntVector(1000);
+    constexpr uint64_t NUMBER_OF_CONSUMERS = 3;
+
+    // Register every consumer before anything is published so that all of them see every message
+    std::vector<pika::Consumer<int>> consumers;
+    for (uint64_t i = 0; i < NUMBER_OF_CONSUMERS; ++i) {
+        auto consumer = pika::Channel::CreateConsumer<int>(params);
+        ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+        consumers.push_back(std::move(*consumer));
+    }
+    std::vector<std::vector<int>> rx_data(NUMBER_OF_CONSUMERS);
+    std::vector<std::thread> consumer_threads;
+    for (uint64_t i = 0; i < NUMBER_OF_CONSUMERS; ++i) {
+        consumer_threads.emplace_back([&, i]() {
+            while (rx_data[i].size() < tx_data.size()) {
+                if (i == 0) {
+                    // One consumer reads through batches, another through zero-copy slots
+                    int packets[5];
+                    auto recv_result = consumers[i].ReceiveBatch(std::span<int>(packets));
+                    if (not recv_result.has_value()) {
+                        return;
+                    }
+                    rx_data[i].insert(rx_data[i].end(), packets, packets + *recv_result);
+                } else if (i == 1) {
+                    auto slot = consumers[i].GetReceiveSlot();
+                    if (not slot.has_value()) {
+                        return;
+                    }
+                    rx_data[i].push_back(**slot);
+                    if (not consumers[i].ReleaseReceiveSlot(*slot).has_value()) {
+                        return;
+                    }
+                } else {
+                    int recv_packet {};
+                    if (not consumers[i].Receive(recv_packet).has_value()) {
+                        return;
+                    }
+                    rx_data[i].push_back(recv_packet);
+                }
+            }
+        });
+    }
+    auto producer = pika::Channel::CreateProducer<int>(params);
+    ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+    // Broadcast channels have a single producer
+    ASSERT_FALSE(pika::Channel::CreateProducer<int>(params).has_value());
+    for (auto const packet : tx_data) {
+        ASSERT_TRUE(producer->Send(packet).has_value());
+    }
+    for (auto& thread : consumer_threads) {
+        thread.join();
+    }
+    for (auto const& rx : rx_data) {
+        ASSERT_EQ(rx, tx_data);
+    }
+}
+
+TEST(InterThreadChannel, TxRxConflating)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 2,
+        .channel_type = pika::ChannelType::InterThread,
+        .queue_mode = pika::QueueMode::Conflating };
+    auto producer = pika::Channel::CreateProducer<uint64_t>(params);
+    ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+    auto consumer = pika::Channel::CreateConsumer<uint64_t>(params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+    // Nothing published yet
+    uint64_t value {};
+    auto recv_result = consumer->Receive(value, 1000);
+    ASSERT_FALSE(recv_result.has_value());
+    ASSERT_EQ(recv_result.error().error_type, PikaErrorType::Timeout);
+
+    // The producer never blocks, consumers only see the latest value
+    for (uint64_t i = 1; i <= 10; ++i) {
+        ASSERT_TRUE(producer->Send(i * 100, 0).has_value());
+    }
+    ASSERT_TRUE(consumer->Receive(value, 0).has_value());
+    ASSERT_EQ(value, 1000);
+    ASSERT_EQ(consumer->GetSequenceNumber(), 10);
+    // The value has not changed since the last read
+    ASSERT_FALSE(consumer->Receive(value, 0).has_value());
+
+    // A consumer that attaches late still gets the latest value
+    auto late_consumer = pika::Channel::CreateConsumer<uint64_t>(params);
+    ASSERT_TRUE(late_consumer.has_value()) << late_consumer.error().error_message;
+    ASSERT_TRUE(late_consumer->Receive(value, 0).has_value());
+    ASSERT_EQ(value, 1000);
+
+    // Reads racing a producer that constantly laps the ring are never torn and never go back in
+    // time
+    struct Sample {
+        uint64_t value;
+        uint64_t inverse;
+    };
+    auto const sample_params = pika::ChannelParameters { .channel_name = "/test_samples",
+        .queue_size = 2,
+        .channel_type = pika::ChannelType::InterThread,
+        .queue_mode = pika::QueueMode::Conflating };
+    auto sample_consumer = pika::Channel::CreateConsumer<Sample>(sample_params);
+    ASSERT_TRUE(sample_consumer.has_value()) << sample_consumer.error().error_message;
+    constexpr uint64_t NUMBER_OF_SAMPLES = 100000;
+    auto thread = std::thread([&]() {
+        auto sample_producer = pika::Channel::CreateProducer<Sample>(sample_params);
+        if (not sample_producer.has_value()) {
+            fmt::println(stderr, "{}", sample_producer.error().error_message);
+            return;
+        }
+        for (uint64_t i = 1; i <= NUMBER_OF_SAMPLES; ++i) {
+            static_cast<void>(sample_producer->Send(Sample { .value = i, .inverse = ~i }));
+        }
+    });
+    uint64_t last_value = 0;
+    while (last_value != NUMBER_OF_SAMPLES) {
+        Sample sample {};
+        ASSERT_TRUE(sample_consumer->Receive(sample).has_value());
+        ASSERT_EQ(sample.inverse, ~sample.value);
+        ASSERT_GT(sample.value, last_value);
+        ASSERT_EQ(sample_consumer->GetSequenceNumber(), sample.value);
+        last_value = sample.value;
+    }
+    thread.join();
+}
+
+TEST(InterThreadChannel, TxRxTripleBuffer)
+{
+    struct Frame {
+        uint64_t id;
+        std::array<uint64_t, 4096> pixels;
+    };
+    auto const params = pika::ChannelParameters { .channel_name = "/test_frames",
+        .channel_type = pika::ChannelType::InterThread,
+        .queue_mode = pika::QueueMode::TripleBuffer };
+    auto producer = pika::Channel::CreateProducer<Frame>(params);
+    ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+    auto consumer = pika::Channel::CreateConsumer<Frame>(params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+    auto second_consumer = pika::Channel::CreateConsumer<Frame>(params);
+    ASSERT_FALSE(second_consumer.has_value());
+
+    // Nothing published yet
+    auto receive_slot = consumer->GetReceiveSlot(0);
+    ASSERT_FALSE(receive_slot.has_value());
+    ASSERT_EQ(receive_slot.error().error_type, PikaErrorType::Timeout);
+
+    // The producer always has a free buffer, even though the consumer never reads
+    for (uint64_t i = 1; i <= 10; ++i) {
+        auto send_slot = producer->GetSendSlot(0);
+        ASSERT_TRUE(send_slot.has_value()) << send_slot.error().error_message;
+        (*send_slot)->id = i;
+        ASSERT_TRUE(producer->ReleaseSendSlot(*send_slot).has_value());
+    }
+    auto latest_slot = consumer->GetReceiveSlot(0);
+    ASSERT_TRUE(latest_slot.has_value()) << latest_slot.error().error_message;
+    ASSERT_EQ((*latest_slot)->id, 10);
+    ASSERT_TRUE(consumer->ReleaseReceiveSlot(*latest_slot).has_value());
+    ASSERT_FALSE(consumer->GetReceiveSlot(0).has_value());
+
+    // Frames held by the consumer are never written to by the producer
+    auto const frame_count = uint64_t { 10000 };
+    auto thread = std::thread([&]() {
+        for (uint64_t i = 11; i <= frame_count; ++i) {
+            auto send_slot = producer->GetSendSlot(0);
+            if (not send_slot.has_value()) {
+                fmt::println(stderr, "{}", send_slot.error().error_message);
+                return;
+            }
+            (*send_slot)->id = i;
+            (*send_slot)->pixels.fill(i);
+            static_cast<void>(producer->ReleaseSendSlot(*send_slot));
+        }
+    });
+    uint64_t last_id = 10;
+    while (last_id != frame_count) {
+        auto frame_slot = consumer->GetReceiveSlot();
+        ASSERT_TRUE(frame_slot.has_value()) << frame_slot.error().error_message;
+        auto const& frame = **frame_slot;
+        ASSERT_GT(frame.id, last_id);
+        ASSERT_EQ(frame.pixels.front(), frame.id);
+        ASSERT_EQ(frame.pixels.back(), frame.id);
+        last_id = frame.id;
+        ASSERT_TRUE(consumer->ReleaseReceiveSlot(*frame_slot).has_value());
+    }
+    thread.join();
+}
+
+TEST(InterThreadChannel, TxRxProducerLanes)
+{
+    struct Message {
+        uint64_t producer_id;
+        uint64_t sequence_number;
+    };
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 8,
+        .channel_type = pika::ChannelType::InterThread,
+        .queue_mode = pika::QueueMode::ProducerLanes };
+    auto consumer = pika::Channel::CreateConsumer<Message>(params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+    auto second_consumer = pika::Channel::CreateConsumer<Message>(params);
+    ASSERT_FALSE(second_consumer.has_value());
+
+    constexpr uint64_t NUMBER_OF_PRODUCERS = 4;
+    constexpr uint64_t NUMBER_OF_MESSAGES = 10000;
+    std::vector<std::thread> producer_threads;
+    for (uint64_t producer_id = 0; producer_id < NUMBER_OF_PRODUCERS; ++producer_id) {
+        producer_threads.emplace_back([&, producer_id]() {
+            auto producer = pika::Channel::CreateProducer<Message>(params);
+            if (not producer.has_value()) {
+                fmt::println(stderr, "{}", producer.error().error_message);
+                return;
+            }
+            for (uint64_t i = 0; i < NUMBER_OF_MESSAGES; i += 2) {
+                static_cast<void>(producer->Send(
+                    Message { .producer_id = producer_id, .sequence_number = i }));
+                auto slot = producer->GetSendSlot();
+                if (not slot.has_value()) {
+                    fmt::println(stderr, "{}", slot.error().error_message);
+                    return;
+                }
+                **slot = Message { .producer_id = producer_id, .sequence_number = i + 1 };
+                static_cast<void>(producer->ReleaseSendSlot(*slot));
+            }
+        });
+    }
+    // Messages of every producer arrive in order
+    std::vector<uint64_t> next_sequence_numbers(NUMBER_OF_PRODUCERS, 0);
+    std::vector<Message> batch(16);
+    uint64_t received_count = 0;
+    while (received_count < NUMBER_OF_PRODUCERS * NUMBER_OF_MESSAGES) {
+        auto result = consumer->ReceiveBatch(batch);
+        ASSERT_TRUE(result.has_value()) << result.error().error_message;
+        for (uint64_t i = 0; i < *result; ++i) {
+            ASSERT_LT(batch[i].producer_id, NUMBER_OF_PRODUCERS);
+            ASSERT_EQ(batch[i].sequence_number, next_sequence_numbers[batch[i].producer_id]++);
+        }
+        received_count += *result;
+    }
+    for (auto& thread : producer_threads) {
+        thread.join();
+    }
+    Message message {};
+    ASSERT_FALSE(consumer->Receive(message, 1000).has_value());
+}
+
+TEST(InterThreadChannel, TxRxBytes)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 1000, // Size of the ring in bytes
+        .channel_type = pika::ChannelType::InterThread };
+    auto producer = pika::Channel::CreateByteProducer(params);
+    ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+    auto consumer = pika::Channel::CreateByteConsumer(params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+    // A record(payload + 8-byte length prefix) larger than the ring can never be sent
+    auto const oversized_message = std::vector<std::byte>(1000);
+    ASSERT_FALSE(producer->SendBytes(oversized_message).has_value());
+    // Element based endpoints cannot attach to a byte stream channel
+    ASSERT_FALSE(pika::Channel::CreateConsumer<int>(params).has_value());
+
+    // A message that does not fit in the receive buffer stays in the channel
+    auto const small_message = std::vector<std::byte>(16, std::byte { 0xAB });
+    ASSERT_TRUE(producer->SendBytes(small_message).has_value());
+    std::vector<std::byte> rx_buffer(1000);
+    ASSERT_FALSE(consumer->ReceiveBytes(std::span(rx_buffer).first(8)).has_value());
+    auto recv_result = consumer->ReceiveBytes(rx_buffer);
+    ASSERT_TRUE(recv_result.has_value()) << recv_result.error().error_message;
+    ASSERT_EQ(*recv_result, small_message.size());
+    recv_result = consumer->ReceiveBytes(rx_buffer, 1000);
+    ASSERT_FALSE(recv_result.has_value());
+    ASSERT_EQ(recv_result.error().error_type, PikaErrorType::Timeout);
+
+    // Messages of varying sizes wrap around the ring many times
+    std::vector<std::vector<std::byte>> tx_messages;
+    for (auto const value : GetRandomIntVector(500)) {
+        auto const size = static_cast<size_t>(value - 1) * 5; // 0 to 255 bytes
+        tx_messages.emplace_back(size, static_cast<std::byte>(value));
+    }
+    auto thread = std::thread([&]() {
+        for (size_t i = 0; i < tx_messages.size(); ++i) {
+            auto const& message = tx_messages[i];
+            if (i % 2 == 0) {
+                if (not producer->SendBytes(message).has_value()) {
+                    fmt::println(stderr, "producer->SendBytes failed");
+                    return;
+                }
+                continue;
+            }
+            // Write the message in place
+            auto reservation = producer->ReserveBytes(message.size());
+            if (not reservation.has_value()) {
+                fmt::println(stderr, "producer->ReserveBytes failed");
+                return;
+            }
+            std::copy(message.begin(), message.end(), reservation->begin());
+            if (not producer->CommitBytes(*reservation).has_value()) {
+                fmt::println(stderr, "producer->CommitBytes failed");
+                return;
+            }
+        }
+    });
+    for (auto const& message : tx_messages) {
+        auto recv_result = consumer->ReceiveBytes(rx_buffer);
+        ASSERT_TRUE(recv_result.has_value()) << recv_result.error().error_message;
+        ASSERT_EQ(*recv_result, message.size());
+        ASSERT_TRUE(std::equal(message.begin(), message.end(), rx_buffer.begin()));
+    }
+    thread.join();
+}
+
+TEST(InterThreadChannel, PowerOfTwoCapacity)
+{
+    auto params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 3,
+        .channel_type = pika::ChannelType::InterThread,
+        .single_producer_single_consumer_mode = true,
+        .power_of_two_capacity_mode = true };
+    auto producer = pika::Channel::CreateProducer<int>(params);
+    ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+
+    // The channel was established with a capacity mode that differs from these parameters
+    params.power_of_two_capacity_mode = false;
+    ASSERT_FALSE(pika::Channel::CreateConsumer<int>(params).has_value());
+    params.power_of_two_capacity_mode = true;
+    auto consumer = pika::Channel::CreateConsumer<int>(params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+    // queue_size is rounded up to 4 and all 4 slots are usable
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(producer->Send(i, 0).has_value());
+    }
+    ASSERT_FALSE(producer->GetSendSlot(1000).has_value());
+    // Wrap around the ring a few times
+    for (int i = 4; i < 64; ++i) {
+        int recv_packet {};
+        ASSERT_TRUE(consumer->Receive(recv_packet).has_value());
+        ASSERT_EQ(recv_packet, i - 4);
+        ASSERT_TRUE(producer->Send(i).has_value());
+    }
+}
+
+TEST(InterThreadChannel, TxRxBatch)
+{
+    auto const channel_parameters = std::vector<pika::ChannelParameters> {
+        { .channel_name = "/test_lock_protected",
+            .queue_size = 16,
+            .channel_type = pika::ChannelType::InterThread },
+        { .channel_name = "/test_spsc",
+            .queue_size = 16,
+            .channel_type = pika::ChannelType::InterThread,
+            .single_producer_single_consumer_mode = true },
+        { .channel_name = "/test_mpmc",
+            .queue_size = 16,
+            .channel_type = pika::ChannelType::InterThread,
+            .queue_mode = pika::QueueMode::LockFree },
+        { .channel_name = "/test_futex_mutex",
+            .queue_size = 16,
+            .channel_type = pika::ChannelType::InterThread,
+            .futex_mutex_mode = true },
+        { .channel_name = "/test_two_lock",
+            .queue_size = 16,
+            .channel_type = pika::ChannelType::InterThread,
+            .queue_mode = pika::QueueMode::TwoLock },
+    };
+    for (auto const& params : channel_parameters) {
+        auto const tx_data = GetRandomIntVector(1000);
+        auto consumer = pika::Channel::CreateConsumer<int>(params);
+        ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+        // min_count can never be satisfied
+        int unused[32];
+        ASSERT_FALSE(consumer->ReceiveBatch(std::span<int>(unused), 17).has_value());
+
+        auto thread = std::thread([&]() {
+            auto producer = pika::Channel::CreateProducer<int>(params);
+            if (not producer.has_value()) {
+                fmt::println(stderr, "{}", producer.error().error_message);
+                return;
+            }
+            // Bursts larger than the queue are split over several publishes
+            for (size_t offset = 0; offset < tx_data.size(); offset += 37) {
+                auto const burst = std::span<int const>(tx_data).subspan(
+                    offset, std::min<size_t>(37, tx_data.size() - offset));
+                auto send_result = producer->SendBatch(burst);
+                if (not send_result.has_value() || *send_result != burst.size()) {
+                    fmt::println(stderr, "producer->SendBatch failed");
+                    return;
+                }
+            }
+        });
+
+        std::vector<int> rx_data;
+        while (rx_data.size() < tx_data.size()) {
+            int packets[10];
+            auto const min_count = std::min<uint64_t>(4, tx_data.size() - rx_data.size());
+            auto recv_result = consumer->ReceiveBatch(std::span<int>(packets), min_count);
+            ASSERT_TRUE(recv_result.has_value()) << recv_result.error().error_message;
+            ASSERT_GE(*recv_result, min_count);
+            rx_data.insert(rx_data.end(), packets, packets + *recv_result);
+        }
+        thread.join();
+        ASSERT_EQ(rx_data, tx_data);
+    }
+}
+
+TEST(InterThreadChannel, WakeupStatistics)
+{
+    for (auto const futex_mutex_mode : { false, true }) {
+        auto const params = pika::ChannelParameters { .channel_name = "/test",
+            .queue_size = 4,
+            .channel_type = pika::ChannelType::InterThread,
+            .futex_mutex_mode = futex_mutex_mode };
+        auto producer = pika::Channel::CreateProducer<int>(params);
+        ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+        auto consumer = pika::Channel::CreateConsumer<int>(params);
+        ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+        // Nobody ever waits, no signal is needed
+        for (int i = 0; i < 4; ++i) {
+            ASSERT_TRUE(producer->Send(i).has_value());
+        }
+        std::array<int, 4> rx_data {};
+        ASSERT_EQ(consumer->ReceiveBatch(rx_data, 4).value_or(0), 4);
+        auto statistics = producer->GetWakeupStatistics();
+        ASSERT_EQ(statistics.signals_sent, 0);
+        ASSERT_EQ(statistics.signals_skipped, 5);
+
+        // A consumer blocked on the empty ring is woken by the next send
+        auto thread = std::thread([&]() {
+            int recv_packet {};
+            if (not consumer->Receive(recv_packet).has_value()) {
+                fmt::println(stderr, "consumer->Receive failed");
+            }
+        });
+        std::this_thread::sleep_for(50ms); // Give the consumer enough time to block
+        ASSERT_TRUE(producer->Send(4).has_value());
+        thread.join();
+        statistics = consumer->GetWakeupStatistics();
+        ASSERT_EQ(statistics.signals_sent, 1);
+        ASSERT_EQ(statistics.signals_skipped, 6);
+
+        // Racing sends and receives are each counted exactly once
+        constexpr int NUMBER_OF_THREADS = 4;
+        constexpr int PACKETS_PER_THREAD = 10000;
+        std::vector<std::thread> threads;
+        for (int thread_index = 0; thread_index < NUMBER_OF_THREADS; ++thread_index) {
+            threads.emplace_back([&]() {
+                auto thread_producer = pika::Channel::CreateProducer<int>(params);
+                for (int i = 0; thread_producer.has_value() && i < PACKETS_PER_THREAD; ++i) {
+                    static_cast<void>(thread_producer->Send(i));
+                }
+            });
+            threads.emplace_back([&]() {
+                auto thread_consumer = pika::Channel::CreateConsumer<int>(params);
+                int recv_packet {};
+                for (int i = 0; thread_consumer.has_value() && i < PACKETS_PER_THREAD; ++i) {
+                    static_cast<void>(thread_consumer->Receive(recv_packet));
+                }
+            });
+        }
+        for (auto& racing_thread : threads) {
+            racing_thread.join();
+        }
+        statistics = producer->GetWakeupStatistics();
+        ASSERT_EQ(statistics.signals_sent + statistics.signals_skipped,
+            7 + (2 * NUMBER_OF_THREADS * PACKETS_PER_THREAD));
+    }
+}
+
+TEST(InterThreadChannel, WaitStrategies)
+{
+    auto const wait_strategies = std::vector<pika::WaitStrategy> {
+        { .type = pika::WaitStrategyType::BusySpin },
+        { .type = pika::WaitStrategyType::SpinPause },
+        { .type = pika::WaitStrategyType::SpinYield, .spin_budget = 16 },
+        { .type = pika::WaitStrategyType::SpinPark, .spin_budget = 16 },
+    };
+    for (auto const& wait_strategy : wait_strategies) {
+        auto params = pika::ChannelParameters { .channel_name = "/test",
+            .queue_size = 4,
+            .channel_type = pika::ChannelType::InterThread,
+            .single_producer_single_consumer_mode = true,
+            .wait_strategy = wait_strategy };
+        auto consumer = pika::Channel::CreateConsumer<int>(params);
+        ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+        // Timeouts are honoured while waiting on an empty ring
+        int recv_packet {};
+        auto recv_result = consumer->Receive(recv_packet, 1000);
+        ASSERT_FALSE(recv_result.has_value());
+        ASSERT_EQ(recv_result.error().error_type, PikaErrorType::Timeout);
+
+        // The channel was established with a different wait strategy
+        auto other_params = params;
+        other_params.wait_strategy.spin_budget += 1;
+        ASSERT_FALSE(pika::Channel::CreateProducer<int>(other_params).has_value());
+
+        auto const tx_data = GetRandomIntVector(1000);
+        auto thread = std::thread([&]() {
+            auto producer = pika::Channel::CreateProducer<int>(params);
+            if (not producer.has_value()) {
+                fmt::println(stderr, "{}", producer.error().error_message);
+                return;
+            }
+            for (auto const packet : tx_data) {
+                if (not producer->Send(packet).has_value()) {
+                    fmt::println(stderr, "producer->Send failed");
+                    return;
+                }
+            }
+        });
+        std::vector<int> rx_data;
+        while (rx_data.size() < tx_data.size()) {
+            ASSERT_TRUE(consumer->Receive(recv_packet).has_value());
+            rx_data.push_back(recv_packet);
+        }
+        thread.join();
+        ASSERT_EQ(rx_data, tx_data);
+    }
+}
+
+TEST(InterThreadChannel, TimeoutsAreBoundedAndSideEffectFree)
+{
+    static constexpr auto TIMEOUT_US = int64_t { 20'000 };
+    // Generous upper bound, the test machine may be loaded
+    static constexpr auto SLACK_US = int64_t { 500'000 };
+    using WatchType = StopWatch<std::chrono::steady_clock>;
+    auto const expect_timeout = [](auto const& result, WatchType const& watch) {
+        auto const elapsed_us = watch.ElapsedDurationUs();
+        ASSERT_FALSE(result.has_value());
+        ASSERT_EQ(result.error().error_type, PikaErrorType::Timeout);
+        ASSERT_GE(elapsed_us, TIMEOUT_US);
+        ASSERT_LT(elapsed_us, TIMEOUT_US + SLACK_US);
+    };
+    struct Mode {
+        pika::QueueMode queue_mode;
+        bool single_producer_single_consumer_mode;
+        bool futex_mutex_mode;
+    };
+    auto const modes = std::vector<Mode> { { pika::QueueMode::LockProtected, false, false },
+        { pika::QueueMode::LockProtected, false, true }, { pika::QueueMode::TwoLock, false, false },
+        { pika::QueueMode::LockFree, false, false },
+        { pika::QueueMode::LockProtected, true, false } };
+    for (auto const& mode : modes) {
+        auto const params = pika::ChannelParameters { .channel_name = "/test",
+            .queue_size = 2,
+            .channel_type = pika::ChannelType::InterThread,
+            .single_producer_single_consumer_mode = mode.single_producer_single_consumer_mode,
+            .queue_mode = mode.queue_mode,
+            .futex_mutex_mode = mode.futex_mutex_mode };
+        auto producer = pika::Channel::CreateProducer<int>(params);
+        ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+        auto consumer = pika::Channel::CreateConsumer<int>(params);
+        ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+        int recv_packet {};
+        WatchType watch;
+        expect_timeout(consumer->Receive(recv_packet, TIMEOUT_US), watch);
+
+        // Receives and sends that time out leave the ring untouched
+        ASSERT_TRUE(producer->Send(1).has_value());
+        std::array<int, 2> rx_data {};
+        watch.Reset();
+        expect_timeout(consumer->ReceiveBatch(rx_data, 2, TIMEOUT_US), watch);
+        ASSERT_TRUE(producer->Send(2).has_value());
+        watch.Reset();
+        expect_timeout(producer->Send(3, TIMEOUT_US), watch);
+        ASSERT_TRUE(consumer->Receive(recv_packet).has_value());
+        ASSERT_EQ(recv_packet, 1);
+        ASSERT_TRUE(consumer->Receive(recv_packet).has_value());
+        ASSERT_EQ(recv_packet, 2);
+        watch.Reset();
+        expect_timeout(consumer->Receive(recv_packet, TIMEOUT_US), watch);
+
+        if (mode.queue_mode == pika::QueueMode::LockProtected
+            && not mode.single_producer_single_consumer_mode) {
+            // The send slot holds the ring's lock, the timeout also bounds waiting for the lock
+            auto slot = producer->GetSendSlot();
+            ASSERT_TRUE(slot.has_value()) << slot.error().error_message;
+            auto thread = std::thread([&]() {
+                WatchType thread_watch;
+                expect_timeout(consumer->Receive(recv_packet, TIMEOUT_US), thread_watch);
+            });
+            thread.join();
+            **slot = 4;
+            ASSERT_TRUE(producer->ReleaseSendSlot(*slot).has_value());
+            ASSERT_TRUE(consumer->Receive(recv_packet).has_value());
+            ASSERT_EQ(recv_packet, 4);
+        }
+    }
+
+    // A reservation that would wrap around the end of a byte stream channel times out without
+    // publishing the padding record, the next one still starts where the last record ended
+    auto const bytes_params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 128,
+        .channel_type = pika::ChannelType::InterThread };
+    auto byte_producer = pika::Channel::CreateByteProducer(bytes_params);
+    ASSERT_TRUE(byte_producer.has_value()) << byte_producer.error().error_message;
+    auto byte_consumer = pika::Channel::CreateByteConsumer(bytes_params);
+    ASSERT_TRUE(byte_consumer.has_value()) << byte_consumer.error().error_message;
+    auto first_reservation = byte_producer->ReserveBytes(56); // 64 byte record
+    ASSERT_TRUE(first_reservation.has_value()) << first_reservation.error().error_message;
+    ASSERT_TRUE(byte_producer->CommitBytes(*first_reservation).has_value());
+    ASSERT_TRUE(byte_producer->SendBytes(std::vector<std::byte>(40)).has_value()); // 48 bytes
+    std::vector<std::byte> rx_buffer(128);
+    ASSERT_TRUE(byte_consumer->ReceiveBytes(rx_buffer).has_value());
+    // 16 bytes are left before the end of the ring, the padding and a 72 byte record do not fit
+    // in the 80 free bytes
+    WatchType watch;
+    expect_timeout(byte_producer->ReserveBytes(64, TIMEOUT_US), watch);
+    auto reservation = byte_producer->ReserveBytes(8, 0);
+    ASSERT_TRUE(reservation.has_value()) << reservation.error().error_message;
+    ASSERT_EQ(reservation->data(), first_reservation->data() + 112);
+}
+
+TEST(InterThreadChannel, AllocationFreeHotPath)
+{
+    struct Mode {
+        pika::QueueMode queue_mode;
+        bool single_producer_single_consumer_mode;
+        bool futex_mutex_mode;
+    };
+    auto const modes = std::vector<Mode> { { pika::QueueMode::LockProtected, false, false },
+        { pika::QueueMode::LockProtected, false, true }, { pika::QueueMode::TwoLock, false, false },
+        { pika::QueueMode::LockFree, false, false },
+        { pika::QueueMode::LockProtected, true, false } };
+    for (auto const& mode : modes) {
+        auto const params = pika::ChannelParameters { .channel_name = "/test",
+            .queue_size = 4,
+            .channel_type = pika::ChannelType::InterThread,
+            .single_producer_single_consumer_mode = mode.single_producer_single_consumer_mode,
+            .queue_mode = mode.queue_mode,
+            .futex_mutex_mode = mode.futex_mutex_mode };
+        auto producer = pika::Channel::CreateProducer<int>(params);
+        ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+        auto consumer = pika::Channel::CreateConsumer<int>(params);
+        ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+
+        // Steady state: sends and receives, sends to a full channel, receives from an empty one
+        // and timed out receives
+        auto send_count = uint64_t { 0 };
+        auto would_block_count = uint64_t { 0 };
+        auto timeout_count = uint64_t { 0 };
+        g_allocation_count = 0;
+        g_count_allocations = true;
+        for (int round = 0; round < 100; ++round) {
+            for (int i = 0; i < 5; ++i) {
+                auto const result = producer->TrySend(i);
+                send_count += result.has_value() ? 1 : 0;
+                would_block_count += not result.has_value()
+                        and result.error().error_type == PikaErrorType::WouldBlock
+                    ? 1
+                    : 0;
+            }
+            int recv_packet {};
+            for (int i = 0; i < 4; ++i) {
+                static_cast<void>(consumer->Receive(recv_packet));
+            }
+            auto const try_result = consumer->TryReceive(recv_packet);
+            would_block_count += not try_result.has_value()
+                    and try_result.error().error_type == PikaErrorType::WouldBlock
+                ? 1
+                : 0;
+            auto const timed_result = consumer->Receive(recv_packet, 1);
+            timeout_count += not timed_result.has_value()
+                    and timed_result.error().error_type == PikaErrorType::Timeout
+                ? 1
+                : 0;
+        }
+        g_count_allocations = false;
+        ASSERT_EQ(g_allocation_count.load(), 0);
+        ASSERT_EQ(send_count, 400);
+        ASSERT_EQ(would_block_count, 200);
+        ASSERT_EQ(timeout_count, 100);
+    }
+    // Only literals are referenced without a copy, a writable buffer could dangle
+    static_assert(std::is_constructible_v<ErrorMessage, char const (&)[8]>);
+    static_assert(not std::is_constructible_v<ErrorMessage, char (&)[8]>);
+}
+
 TEST(InterThreadChannel, TxRxWithTimeouts)
 {
     auto const params = pika::ChannelParameters {
@@ -205,4 +1077,96 @@ TEST(InterThreadChannel, TxRxWithTimeouts)
     }
 
     thread.join();
-}
\ No newline at end of file
+}
+TEST(InterThreadChannel, ChannelPair)
+{
+    // Pairs are not registered, so two pairs never meet even if they share a name
+    auto const params = pika::ChannelParameters { .channel_name = "/test",
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::InterThread,
+        .single_producer_single_consumer_mode = true };
+    auto first_pair = pika::Channel::CreatePair<uint64_t>(params);
+    ASSERT_TRUE(first_pair.has_value()) << first_pair.error().error_message;
+    auto second_pair = pika::Channel::CreatePair<uint64_t>(params);
+    ASSERT_TRUE(second_pair.has_value()) << second_pair.error().error_message;
+    ASSERT_TRUE(first_pair->producer.IsConnected());
+    ASSERT_TRUE(first_pair->consumer.IsConnected());
+    auto registered_producer = pika::Channel::CreateProducer<uint64_t>(params);
+    ASSERT_TRUE(registered_producer.has_value()) << registered_producer.error().error_message;
+
+    constexpr uint64_t NUMBER_OF_PACKETS = 1000;
+    auto consumer_thread = std::thread([&]() {
+        for (uint64_t i = 0; i < NUMBER_OF_PACKETS; ++i) {
+            uint64_t recv_packet {};
+            ASSERT_TRUE(first_pair->consumer.Receive(recv_packet).has_value());
+            ASSERT_EQ(recv_packet, i);
+        }
+    });
+    for (uint64_t i = 0; i < NUMBER_OF_PACKETS; ++i) {
+        ASSERT_TRUE(first_pair->producer.Send(i).has_value());
+    }
+    consumer_thread.join();
+    uint64_t recv_packet {};
+    ASSERT_EQ(second_pair->consumer.TryReceive(recv_packet).error().error_type,
+        PikaErrorType::WouldBlock);
+
+    // The segment outlives the endpoint destroyed first
+    {
+        auto producer = std::move(second_pair->producer);
+    }
+    ASSERT_FALSE(second_pair->consumer.IsConnected());
+
+    // Huge pages are used when available, otherwise the reason is reported
+    auto huge_page_params = params;
+    huge_page_params.queue_size = 1 << 16;
+    huge_page_params.huge_page_mode = pika::HugePageMode::Transparent;
+    auto huge_page_pair = pika::Channel::CreatePair<uint64_t>(huge_page_params);
+    ASSERT_TRUE(huge_page_pair.has_value()) << huge_page_pair.error().error_message;
+    auto const backing = huge_page_pair->producer.GetSegmentBacking();
+    ASSERT_TRUE(backing.huge_page_mode == pika::HugePageMode::Transparent
+        || not backing.fallback_reason.empty());
+    ASSERT_TRUE(huge_page_pair->producer.Send(42).has_value());
+    ASSERT_TRUE(huge_page_pair->consumer.Receive(recv_packet).has_value());
+    ASSERT_EQ(recv_packet, 42);
+
+    auto inter_process_params = params;
+    inter_process_params.channel_type = pika::ChannelType::InterProcess;
+    ASSERT_FALSE(pika::Channel::CreatePair<uint64_t>(inter_process_params).has_value());
+}
+
+TEST(InterThreadChannel, ConcurrentNamedChannels)
+{
+    // Endpoints of many named channels created and destroyed concurrently
+    constexpr int NUMBER_OF_THREADS = 8;
+    constexpr int ITERATIONS = 200;
+    std::vector<std::thread> threads;
+    std::atomic_bool success = true;
+    for (int thread_index = 0; thread_index < NUMBER_OF_THREADS; ++thread_index) {
+        threads.emplace_back([&, thread_index]() {
+            for (int i = 0; i < ITERATIONS; ++i) {
+                // Every channel is shared by two threads
+                auto const params = pika::ChannelParameters {
+                    .channel_name = fmt::format("/test_{}_{}", thread_index / 2, i % 4),
+                    .queue_size = 4,
+                    .channel_type = pika::ChannelType::InterThread
+                };
+                auto producer = pika::Channel::CreateProducer<int>(params);
+                auto consumer = pika::Channel::CreateConsumer<int>(params);
+                if (not producer.has_value() || not consumer.has_value()
+                    || not producer->Send(i).has_value()) {
+                    success = false;
+                    return;
+                }
+                int recv_packet {};
+                if (not consumer->Receive(recv_packet).has_value()) {
+                    success = false;
+                    return;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    ASSERT_TRUE(success);
+}
@@ -0,0 +1,114 @@
+#include "channel_interface.hpp"
+#include "impl/tsc_clock.hpp"
+#include "process_fork.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <gtest/gtest.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+
+using namespace std::chrono_literals;
+
+static constexpr auto CHILD_ENVIRONMENT_VARIABLE = "PIKA_TSC_CLOCK_TEST_CHILD";
+
+// Runs test_name of the TscClock suite again in a freshly executed process, which has not taken
+// or adopted a calibration yet. child_argument is handed to it through CHILD_ENVIRONMENT_VARIABLE.
+static auto RunInFreshProcess(std::string const& test_name, std::string const& child_argument)
+    -> std::expected<void, PikaError>
+{
+    auto child_process_handle = ChildProcessHandle::RunChildFunction([&]() -> ChildProcessState {
+        auto const filter = fmt::format("--gtest_filter=TscClock.{}", test_name);
+        if (setenv(CHILD_ENVIRONMENT_VARIABLE, child_argument.c_str(), 1) != 0) {
+            return ChildProcessState::FAIL;
+        }
+        execl("/proc/self/exe", "test_pika", filter.c_str(), nullptr);
+        fmt::println(stderr, "execl failed");
+        return ChildProcessState::FAIL;
+    });
+    if (not child_process_handle.has_value()) {
+        return std::unexpected(child_process_handle.error());
+    }
+    return child_process_handle->WaitForChildProcess();
+}
+
+TEST(TscClock, ConvertsToMonotonicTime)
+{
+    auto const& calibration = TscClock::GetCalibration();
+    ASSERT_EQ(calibration.UsesTsc(), TscClock::HasInvariantTsc());
+
+    auto const monotonic_before = TscClock::GetMonotonicNs();
+    auto const ticks = TscClock::Now();
+    auto const monotonic_after = TscClock::GetMonotonicNs();
+    // The calibration error accumulates since the calibration point, a few seconds ago at most
+    static constexpr auto TOLERANCE_NS = uint64_t { 10'000'000 };
+    auto const monotonic_ns = TscClock::ToMonotonicNs(ticks);
+    ASSERT_GE(monotonic_ns + TOLERANCE_NS, monotonic_before);
+    ASSERT_LE(monotonic_ns, monotonic_after + TOLERANCE_NS);
+
+    std::this_thread::sleep_for(20ms);
+    auto const elapsed_ns = TscClock::ToNanoseconds(TscClock::Now() - ticks);
+    ASSERT_GE(elapsed_ns, 19'000'000);
+    ASSERT_LT(elapsed_ns, 520'000'000);
+}
+
+TEST(TscClock, FallsBackToMonotonicClock)
+{
+    if (getenv(CHILD_ENVIRONMENT_VARIABLE) == nullptr) {
+        auto result = RunInFreshProcess("FallsBackToMonotonicClock", "fallback");
+        ASSERT_TRUE(result.has_value()) << result.error().error_message;
+        return;
+    }
+    // A process without an invariant TSC calibrates to this, ticks are then CLOCK_MONOTONIC
+    // nanoseconds
+    TscClock::AdoptCalibration(TscCalibration {});
+    ASSERT_FALSE(TscClock::GetCalibration().UsesTsc());
+    auto const monotonic_before = TscClock::GetMonotonicNs();
+    auto const ticks = TscClock::Now();
+    auto const monotonic_after = TscClock::GetMonotonicNs();
+    ASSERT_GE(ticks, monotonic_before);
+    ASSERT_LE(ticks, monotonic_after);
+    ASSERT_EQ(TscClock::ToNanoseconds(12345), 12345);
+    ASSERT_EQ(TscClock::ToMonotonicNs(ticks), ticks);
+}
+
+TEST(TscClock, AdoptsCalibrationOfChannelCreator)
+{
+    auto const params = pika::ChannelParameters { .channel_name = "/test_tsc_clock",
+        .queue_size = 4,
+        .channel_type = pika::ChannelType::InterProcess };
+    auto const child_argument = getenv(CHILD_ENVIRONMENT_VARIABLE);
+    if (child_argument == nullptr) {
+        // The creator stores its calibration in the channel header
+        auto producer = pika::Channel::CreateProducer<int>(params);
+        ASSERT_TRUE(producer.has_value()) << producer.error().error_message;
+        auto const& calibration = TscClock::GetCalibration();
+        auto result = RunInFreshProcess("AdoptsCalibrationOfChannelCreator",
+            fmt::format("{} {} {:a}", calibration.reference_ticks,
+                calibration.reference_monotonic_ns, calibration.ns_per_tick));
+        ASSERT_TRUE(result.has_value()) << result.error().error_message;
+        return;
+    }
+    char* end = nullptr;
+    auto const reference_ticks = std::strtoull(child_argument, &end, 10);
+    auto const reference_monotonic_ns = std::strtoull(end, &end, 10);
+    auto const ns_per_tick = std::strtod(end, &end);
+
+    // Attaching to the channel adopts the creator's calibration instead of calibrating
+    auto consumer = pika::Channel::CreateConsumer<int>(params);
+    ASSERT_TRUE(consumer.has_value()) << consumer.error().error_message;
+    auto const& calibration = TscClock::GetCalibration();
+    ASSERT_EQ(calibration.reference_ticks, reference_ticks);
+    ASSERT_EQ(calibration.reference_monotonic_ns, reference_monotonic_ns);
+    ASSERT_EQ(calibration.ns_per_tick, ns_per_tick);
+    if (calibration.UsesTsc()) {
+        ASSERT_EQ(TscClock::ToMonotonicNs(reference_ticks), reference_monotonic_ns);
+    }
+
+    // A process keeps the calibration it has
+    TscClock::AdoptCalibration(TscCalibration {});
+    ASSERT_EQ(TscClock::GetCalibration().ns_per_tick, ns_per_tick);
+}